@@ -0,0 +1,145 @@
+// Benchmarks of the interpreter running the roms in roms/games
+
+#include <filesystem>
+#include <string>
+
+namespace
+{
+// Instructions run on each game per benchmark iteration
+constexpr unsigned int GAME_SLICE = 1000;
+
+// One interpreter per game rom, sorted by path so runs are comparable
+std::vector<std::unique_ptr<chip8::Interpreter>> load_games(void)
+{
+	std::vector<std::string> paths;
+	for (const auto &entry : std::filesystem::directory_iterator(std::string(ROM_DIR) + "/games"))
+	{
+		if (entry.path().extension() == ".ch8")
+			paths.push_back(entry.path().string());
+	}
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<std::unique_ptr<chip8::Interpreter>> games;
+	for (const auto &path : paths)
+	{
+		std::unique_ptr<chip8::FlatMemory> memory;
+		if (chip8::load_rom(path, memory) == chip8::RomStatus::OK)
+			games.push_back(chip8::Interpreter::make_interpreter(std::move(memory)));
+	}
+
+	return games;
+}
+} // anonymous namespace
+
+// Games through next_instruction and the predecode cache
+static void BM_Games_Predecoded(benchmark::State &state)
+{
+	auto games = load_games();
+
+	for (auto _ : state)
+		for (auto &game : games)
+			for (unsigned int i = 0; i < GAME_SLICE; ++i)
+				game->next_instruction();
+
+	state.SetItemsProcessed(state.iterations() * games.size() * GAME_SLICE);
+}
+BENCHMARK(BM_Games_Predecoded)->Apply(repetition_statistics);
+
+// Games through run_cycles, one call per slice with threaded dispatch inside
+static void BM_Games_RunCycles(benchmark::State &state)
+{
+	auto games = load_games();
+	uint64_t instructions = 0;
+
+	for (auto _ : state)
+		for (auto &game : games)
+		{
+			// Key waits return early, so count what actually ran
+			uint64_t before = game->cycles();
+			game->run_cycles(GAME_SLICE);
+			instructions += game->cycles() - before;
+		}
+
+	state.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_Games_RunCycles)->Apply(repetition_statistics);
+
+// Games through run_cycles with the recompiler translating their blocks
+static void BM_Games_Jit(benchmark::State &state)
+{
+	auto games = load_games();
+	uint64_t instructions = 0;
+
+	for (auto &game : games)
+		if (!game->enable_jit(true))
+		{
+			state.SkipWithError("Recompiler unsupported on this host");
+			return;
+		}
+
+	for (auto _ : state)
+		for (auto &game : games)
+		{
+			uint64_t before = game->cycles();
+			game->run_cycles(GAME_SLICE);
+			instructions += game->cycles() - before;
+		}
+
+	state.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_Games_Jit)->Apply(repetition_statistics);
+
+// Games through run_cycles recording every instruction into an in memory trace ring, against BM_Games_RunCycles
+static void BM_Games_Traced(benchmark::State &state)
+{
+	auto games = load_games();
+	uint64_t instructions = 0;
+
+	for (auto &game : games)
+		game->set_trace(chip8::TraceRing::make_trace_ring(1 << 16));
+
+	for (auto _ : state)
+		for (auto &game : games)
+		{
+			uint64_t before = game->cycles();
+			game->run_cycles(GAME_SLICE);
+			instructions += game->cycles() - before;
+		}
+
+	state.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_Games_Traced)->Apply(repetition_statistics);
+
+// Games fetching and decoding every instruction again, as before the predecode cache
+static void BM_Games_DecodeEveryTime(benchmark::State &state)
+{
+	auto games = load_games();
+
+	for (auto _ : state)
+		for (auto &game : games)
+			for (unsigned int i = 0; i < GAME_SLICE; ++i)
+			{
+				unsigned int opcode = game->m_ram->fetch_opcode(game->m_program_counter);
+				game->m_program_counter += 2;
+				game->execute(opcode);
+			}
+
+	state.SetItemsProcessed(state.iterations() * games.size() * GAME_SLICE);
+}
+BENCHMARK(BM_Games_DecodeEveryTime)->Apply(repetition_statistics);
+
+// Packed screen rows to ARGB pixels, the conversion a front end does per presented frame
+static void BM_Screen_Argb(benchmark::State &state)
+{
+	auto games = load_games();
+	chip8::Interpreter &game = *games.front();
+
+	// Something on screen
+	game.run_cycles(20000);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(game.screen());
+
+	state.SetItemsProcessed(state.iterations() * chip8::SCRN_WIDTH * chip8::SCRN_HEIGHT);
+}
+BENCHMARK(BM_Screen_Argb)->Apply(repetition_statistics);
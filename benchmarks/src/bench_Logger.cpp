@@ -0,0 +1,23 @@
+// Benchmarks of the cost of logging to the calling thread
+
+namespace
+{
+// Discards everything the writer thread writes
+std::ostream null_output(nullptr);
+} // anonymous namespace
+
+// One error at the instruction rate, as an unknown opcode loop logs it. The writer dedups, the caller only pushes
+static void BM_Log_RepeatedError(benchmark::State &state)
+{
+	util::Logger *logger = util::Logger::get_instance();
+	logger->set_output(null_output);
+	logger->set_max_log_level(LOGTYPE::ERROR);
+
+	for (auto _ : state)
+		util::LOG(LOGTYPE::ERROR, "Opcode: 0x5121 at 0x200 is unknown");
+
+	logger->set_max_log_level(LOGTYPE::NONE);
+	logger->set_output(std::cout);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Log_RepeatedError)->Apply(repetition_statistics);
@@ -0,0 +1,126 @@
+// Benchmarks comparing the unordered_map backed MemoryMap against FlatMemory
+
+#include <vector>
+
+namespace
+{
+// Loop touching every memory path in the interpreter: fetch, Fx33, Fx55, Fx65 and Dxyn
+const std::vector<uint8_t> MEMORY_LOOP = {
+	0x60, 0x05,		// 200: V0 = 5
+	0x61, 0x03,		// 202: V1 = 3
+	0xA3, 0x00,		// 204: I = 0x300
+	0xF2, 0x33,		// 206: BCD of V2 at I
+	0xF2, 0x55,		// 208: Store V0 to V2 at I
+	0xF2, 0x65,		// 20A: Read V0 to V2 from I
+	0xD0, 0x15,		// 20C: Draw 5 rows at (V0, V1)
+	0x72, 0x01,		// 20E: V2 += 1
+	0x12, 0x00		// 210: Jump to 200
+};
+
+// Fill a memory map with zeros, then the program at the chip8 program start
+template <typename Memory>
+void load_program(Memory &memory, const std::vector<uint8_t> &program)
+{
+	for (unsigned int adr = 0; adr < chip8::FlatMemory::SIZE; ++adr)
+		memory.store(std::byte(0), adr, true);
+
+	for (unsigned int i = 0; i < program.size(); ++i)
+		memory.store(std::byte(program[i]), chip8::PROG_START + i, true);
+}
+} // anonymous namespace
+
+// Instruction throughput with the hashed memory map and virtual reads
+static void BM_Interpreter_MemoryMap(benchmark::State &state)
+{
+	std::unique_ptr<chip8::MemoryMap> memory = chip8::MemoryMap::makeMemoryMap(chip8::FlatMemory::SIZE - 1);
+	load_program(*memory, MEMORY_LOOP);
+	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory));
+
+	for (auto _ : state)
+		interpreter->next_instruction();
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Interpreter_MemoryMap)->Apply(repetition_statistics);
+
+// Instruction throughput with contiguous memory and the inlined fast path
+static void BM_Interpreter_FlatMemory(benchmark::State &state)
+{
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	load_program(*memory, MEMORY_LOOP);
+	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory));
+
+	for (auto _ : state)
+		interpreter->next_instruction();
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Interpreter_FlatMemory)->Apply(repetition_statistics);
+
+// Opcode sized reads through the virtual, validated MemoryMap interface
+static void BM_MemoryMap_Read(benchmark::State &state)
+{
+	std::unique_ptr<chip8::MemoryMap> memory = chip8::MemoryMap::makeMemoryMap(chip8::FlatMemory::SIZE - 1);
+	load_program(*memory, MEMORY_LOOP);
+	unsigned int adr = 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(memory->read(adr));
+		adr = (adr + 1) & chip8::FlatMemory::ADR_MASK;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryMap_Read)->Apply(repetition_statistics);
+
+// Reads through the inlined FlatMemory fast path
+static void BM_FlatMemory_Fetch(benchmark::State &state)
+{
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	load_program(*memory, MEMORY_LOOP);
+	unsigned int adr = 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(memory->fetch(adr));
+		adr = (adr + 1) & chip8::FlatMemory::ADR_MASK;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlatMemory_Fetch)->Apply(repetition_statistics);
+
+// Byte stores through the virtual, validated MemoryMap interface
+static void BM_MemoryMap_Store(benchmark::State &state)
+{
+	std::unique_ptr<chip8::MemoryMap> memory = chip8::MemoryMap::makeMemoryMap(chip8::FlatMemory::SIZE - 1);
+	load_program(*memory, MEMORY_LOOP);
+	unsigned int adr = 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(memory->store(std::byte(adr), adr, true));
+		adr = (adr + 1) & chip8::FlatMemory::ADR_MASK;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryMap_Store)->Apply(repetition_statistics);
+
+// Byte stores through the inlined FlatMemory fast path
+static void BM_FlatMemory_Write(benchmark::State &state)
+{
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	unsigned int adr = 0;
+
+	for (auto _ : state)
+	{
+		memory->write(std::byte(adr), adr);
+		adr = (adr + 1) & chip8::FlatMemory::ADR_MASK;
+	}
+
+	benchmark::DoNotOptimize(memory->data());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlatMemory_Write)->Apply(repetition_statistics);
@@ -0,0 +1,106 @@
+// Throughput of every opcode handler, called directly on a predecoded instruction
+
+#include <string>
+
+namespace
+{
+// Opcode handlers called per benchmark iteration, enough to hide the loop around them
+constexpr unsigned int HANDLER_BATCH = 64;
+
+// A representative opcode of a handler, and a register setup that keeps it on its common path
+struct OpcodeCase
+{
+	const char *name;
+	unsigned int opcode;
+	void (*setup)(chip8::Interpreter &cpu);
+};
+
+void no_setup(chip8::Interpreter &) {}
+
+// Calls and returns pair up, so both run each time
+void stack_setup(chip8::Interpreter &cpu) { cpu.m_sp = 0; }
+
+// A pressed key, so Fx0A never waits
+void key_setup(chip8::Interpreter &cpu) { cpu.set_key_mask(1u << 5); cpu.m_registers[0] = 5; }
+
+// I at a scratch area, so stores never reach the code being run
+void store_setup(chip8::Interpreter &cpu) { cpu.m_index_register = 0x800; }
+
+// Font glyph in bounds of memory
+void draw_setup(chip8::Interpreter &cpu) { cpu.m_index_register = 0x50; cpu.m_registers[0] = 60; cpu.m_registers[1] = 30; }
+
+const OpcodeCase OPCODE_CASES[] = {
+	{ "00E0", 0x00E0, draw_setup },
+	{ "1nnn", 0x1200, no_setup },
+	{ "2nnn_00EE", 0x2200, stack_setup },
+	{ "3xnn", 0x3001, no_setup },
+	{ "4xnn", 0x4001, no_setup },
+	{ "5xy0", 0x5010, no_setup },
+	{ "6xnn", 0x6012, no_setup },
+	{ "7xnn", 0x7001, no_setup },
+	{ "8xy0", 0x8010, no_setup },
+	{ "8xy1", 0x8011, no_setup },
+	{ "8xy2", 0x8012, no_setup },
+	{ "8xy3", 0x8013, no_setup },
+	{ "8xy4", 0x8014, no_setup },
+	{ "8xy5", 0x8015, no_setup },
+	{ "8xy6", 0x8016, no_setup },
+	{ "8xy7", 0x8017, no_setup },
+	{ "8xyE", 0x801E, no_setup },
+	{ "9xy0", 0x9010, no_setup },
+	{ "Annn", 0xA300, no_setup },
+	{ "Bnnn", 0xB200, no_setup },
+	{ "Cxnn", 0xC0FF, no_setup },
+	{ "Dxyn", 0xD015, draw_setup },
+	{ "Ex9E", 0xE09E, key_setup },
+	{ "ExA1", 0xE0A1, key_setup },
+	{ "Fx07", 0xF007, no_setup },
+	{ "Fx0A", 0xF00A, key_setup },
+	{ "Fx15", 0xF015, no_setup },
+	{ "Fx18", 0xF018, no_setup },
+	{ "Fx1E", 0xF01E, store_setup },
+	{ "Fx29", 0xF029, no_setup },
+	{ "Fx33", 0xF033, store_setup },
+	{ "Fx55", 0xFF55, store_setup },
+	{ "Fx65", 0xFF65, store_setup },
+};
+
+// One handler, HANDLER_BATCH calls per iteration
+void BM_Opcode(benchmark::State &state, const OpcodeCase &test)
+{
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	chip8::load_image(*memory, std::span<const std::byte>());
+	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory));
+	chip8::Interpreter &cpu = *interpreter;
+
+	const chip8::Interpreter::Instruction op = chip8::Interpreter::decode(test.opcode);
+	const chip8::Interpreter::Instruction ret = chip8::Interpreter::decode(0x00EE);
+	const chip8::Interpreter::Handler handler = chip8::Interpreter::handlers<chip8::QUIRKS_NONE>[op.kind];
+	const bool call = op.kind == chip8::Interpreter::OP_2nnn;
+
+	for (auto _ : state)
+	{
+		// Setup runs per batch, so state changed by the handler, e.g. Fx1E moving I, stays bounded
+		test.setup(cpu);
+
+		for (unsigned int i = 0; i < HANDLER_BATCH; ++i)
+		{
+			handler(&cpu, op);
+			if (call)
+				chip8::Interpreter::handlers<chip8::QUIRKS_NONE>[ret.kind](&cpu, ret);
+		}
+
+		benchmark::DoNotOptimize(cpu.m_registers);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * HANDLER_BATCH);
+}
+} // anonymous namespace
+
+// Called from main, before the benchmarks run
+void register_opcode_benchmarks(void)
+{
+	for (const OpcodeCase &test : OPCODE_CASES)
+		benchmark::RegisterBenchmark((std::string("BM_Opcode/") + test.name).c_str(), BM_Opcode, test)->Apply(repetition_statistics);
+}
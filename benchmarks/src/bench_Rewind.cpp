@@ -0,0 +1,82 @@
+// Benchmarks of the per frame rewind capture
+
+namespace
+{
+// Rom with a busy screen and random numbers every frame
+const char *REWIND_ROM = "/demos/Particle Demo [zeroZshadow, 2008].ch8";
+
+// Interpreter at power on with REWIND_ROM loaded
+std::unique_ptr<chip8::Interpreter> rewind_interpreter(void)
+{
+	std::unique_ptr<chip8::FlatMemory> memory;
+	chip8::load_rom(std::string(ROM_DIR) + REWIND_ROM, memory);
+	return chip8::Interpreter::make_interpreter(std::move(memory));
+}
+} // anonymous namespace
+
+// One 60 Hz frame of a rom, then the capture main does after it
+static void BM_Rewind_Frame(benchmark::State &state)
+{
+	std::unique_ptr<chip8::Interpreter> interpreter = rewind_interpreter();
+	chip8::RewindBuffer history(30 * 60);
+	chip8::SaveState snapshot;
+
+	for (auto _ : state)
+	{
+		interpreter->run_cycles(10);
+		interpreter->tick_timers();
+		interpreter->save_state(snapshot);
+		history.push(snapshot);
+	}
+
+	state.counters["history_bytes"] = history.bytes();
+	state.counters["bytes_per_frame"] = (double)history.bytes() / history.size();
+}
+BENCHMARK(BM_Rewind_Frame)->Apply(repetition_statistics);
+
+// Capture alone, on a state that changes like a running rom's
+static void BM_Rewind_Capture(benchmark::State &state)
+{
+	std::unique_ptr<chip8::Interpreter> interpreter = rewind_interpreter();
+	chip8::RewindBuffer history(30 * 60);
+	chip8::SaveState snapshot;
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		interpreter->run_cycles(10);
+		interpreter->tick_timers();
+		state.ResumeTiming();
+
+		interpreter->save_state(snapshot);
+		history.push(snapshot);
+	}
+}
+BENCHMARK(BM_Rewind_Capture)->Apply(repetition_statistics);
+
+// Stepping back one frame
+static void BM_Rewind_Pop(benchmark::State &state)
+{
+	std::unique_ptr<chip8::Interpreter> interpreter = rewind_interpreter();
+	chip8::RewindBuffer history(30 * 60);
+	chip8::SaveState snapshot;
+
+	for (auto _ : state)
+	{
+		if (history.size() == 0)
+		{
+			state.PauseTiming();
+			for (int i = 0; i < 30 * 60; ++i)
+			{
+				interpreter->run_cycles(10);
+				interpreter->save_state(snapshot);
+				history.push(snapshot);
+			}
+			state.ResumeTiming();
+		}
+
+		history.pop(snapshot);
+		interpreter->load_state(snapshot);
+	}
+}
+BENCHMARK(BM_Rewind_Pop)->Apply(repetition_statistics);
@@ -0,0 +1,92 @@
+// Benchmarks of getting a rom into memory
+
+#include <filesystem>
+
+namespace
+{
+// Largest rom of the games directory, the worst case of a load
+std::string largest_game(void)
+{
+	std::string largest;
+	uintmax_t size = 0;
+
+	for (const auto &entry : std::filesystem::directory_iterator(std::string(ROM_DIR) + "/games"))
+	{
+		if (entry.path().extension() == ".ch8" && entry.file_size() > size)
+		{
+			size = entry.file_size();
+			largest = entry.path().string();
+		}
+	}
+
+	return largest;
+}
+} // anonymous namespace
+
+// File to a new memory map, as at start up
+static void BM_Rom_Load(benchmark::State &state)
+{
+	const std::string path = largest_game();
+
+	for (auto _ : state)
+	{
+		std::unique_ptr<chip8::FlatMemory> memory;
+		benchmark::DoNotOptimize(chip8::load_rom(path, memory));
+	}
+
+	state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Rom_Load)->Apply(repetition_statistics);
+
+// Rom bytes already read, into an existing memory map, as the parallel runner does between jobs
+static void BM_Rom_LoadImage(benchmark::State &state)
+{
+	std::vector<std::byte> rom;
+	chip8::read_rom_file(largest_game(), rom);
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+
+	for (auto _ : state)
+	{
+		chip8::load_image(*memory, rom);
+		benchmark::DoNotOptimize(memory->data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * chip8::FlatMemory::SIZE);
+}
+BENCHMARK(BM_Rom_LoadImage)->Apply(repetition_statistics);
+
+// Repeated load of one rom through the cache: map, hash and share the image built by the first load
+static void BM_Rom_CacheHit(benchmark::State &state)
+{
+	const std::string path = largest_game();
+	chip8::RomCache cache;
+	std::shared_ptr<const chip8::RomImage> image;
+	cache.load(path, image);
+
+	for (auto _ : state)
+	{
+		cache.load(path, image);
+		benchmark::DoNotOptimize(image.get());
+	}
+
+	state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+}
+BENCHMARK(BM_Rom_CacheHit)->Apply(repetition_statistics);
+
+// Cached image into an existing memory map, one block copy
+static void BM_Rom_LoadCachedImage(benchmark::State &state)
+{
+	chip8::RomCache cache;
+	std::shared_ptr<const chip8::RomImage> image;
+	cache.load(largest_game(), image);
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+
+	for (auto _ : state)
+	{
+		chip8::load_image(*memory, *image);
+		benchmark::DoNotOptimize(memory->data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * chip8::FlatMemory::SIZE);
+}
+BENCHMARK(BM_Rom_LoadCachedImage)->Apply(repetition_statistics);
@@ -0,0 +1,84 @@
+// Warmup, repetition and outlier statistics shared by every benchmark
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Middle of a sample, averaging the two middle values of an even one
+double median_of(std::vector<double> values)
+{
+	if (values.empty())
+		return 0.0;
+
+	std::sort(values.begin(), values.end());
+	const size_t mid = values.size() / 2;
+	return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+// Median absolute deviation, a spread that a few outliers can not inflate
+double median_absolute_deviation(const std::vector<double> &values)
+{
+	const double median = median_of(values);
+
+	std::vector<double> deviations;
+	for (const double &value : values)
+		deviations.push_back(std::abs(value - median));
+
+	return median_of(deviations);
+}
+
+// Share of repetitions further than 3 scaled MADs from the median, about 3 standard deviations for normal noise
+double outlier_share(const std::vector<double> &values)
+{
+	if (values.empty())
+		return 0.0;
+
+	const double median = median_of(values);
+	const double limit = 3.0 * 1.4826 * median_absolute_deviation(values);
+
+	const auto outliers = std::count_if(values.begin(), values.end(), [&](const double &value) {
+		return std::abs(value - median) > limit;
+	});
+	return (double)outliers / values.size();
+}
+
+double min_of(const std::vector<double> &values) { return values.empty() ? 0.0 : *std::min_element(values.begin(), values.end()); }
+double max_of(const std::vector<double> &values) { return values.empty() ? 0.0 : *std::max_element(values.begin(), values.end()); }
+
+// Min, max, MAD and outlier share across repetitions, on top of the built in mean, median and stddev
+void repetition_statistics(benchmark::internal::Benchmark *bench)
+{
+	bench->ComputeStatistics("min", min_of)
+		->ComputeStatistics("max", max_of)
+		->ComputeStatistics("mad", median_absolute_deviation)
+		->ComputeStatistics("outliers", outlier_share, benchmark::StatisticUnit::kPercentage);
+}
+
+// Flags every run gets unless given on the command line. Warm caches and predecode first, then repeat for statistics
+const std::vector<std::string> DEFAULT_FLAGS = {
+	"--benchmark_min_warmup_time=0.05",
+	"--benchmark_repetitions=5",
+	"--benchmark_display_aggregates_only=true"
+};
+
+// Command line with every default flag that was not overridden
+std::vector<char*> with_default_flags(int argc, char **argv)
+{
+	std::vector<char*> args(argv, argv + argc);
+
+	for (const std::string &flag : DEFAULT_FLAGS)
+	{
+		const std::string name = flag.substr(0, flag.find('='));
+		const bool given = std::any_of(argv + 1, argv + argc, [&](const char *arg) {
+			return std::string(arg).rfind(name + "=", 0) == 0;
+		});
+
+		if (!given)
+			args.push_back(const_cast<char*>(flag.c_str()));
+	}
+
+	return args;
+}
+} // anonymous namespace
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+// Standard headers go in before private is redefined
+#include <sstream>
+#include <fstream>
+#include <random>
+#include <cstring>
+#include <deque>
+
+#define private public
+
+#include "../../src/Memory.cpp"
+#include "../../src/Interpreter.cpp"
+#include "../../src/Recompiler.cpp"
+#include "../../src/Trace.cpp"
+#include "../../src/Logger.cpp"
+#include "../../src/Rom.cpp"
+#include "../../src/Platform.cpp"
+#include "../../src/Rewind.cpp"
+
+#include "bench_Statistics.cpp"
+#include "bench_Memory.cpp"
+#include "bench_Interpreter.cpp"
+#include "bench_Opcodes.cpp"
+#include "bench_Rom.cpp"
+#include "bench_Rewind.cpp"
+#include "bench_Logger.cpp"
+
+int main(int argc, char **argv){
+	// Benchmarks measure the interpreter, not the console
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE);
+
+	register_opcode_benchmarks();
+
+	// Warmup and repetitions unless the command line sets them
+	std::vector<char*> args = with_default_flags(argc, argv);
+	int count = (int)args.size();
+
+	benchmark::Initialize(&count, args.data());
+	if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,240 @@
+#ifndef CHIP8_CATALOGUE_H
+#define CHIP8_CATALOGUE_H
+
+// Project includes
+#include "Platform.h"	// Detected platform and its quirks
+
+// C++ includes
+#include <cstddef>		// Sizes
+#include <cstdint>		// Fixed width integers
+#include <memory>		// Factory methods
+#include <string>		// File paths
+#include <string_view>	// Strings in the index
+#include <vector>		// Scanned roms and index storage
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Everything known about one rom file, as scanned
+ */
+struct CatalogueRecord
+{
+	/** Path under the corpus root, with forward slashes */
+	std::string path;
+
+	/** rom_hash of the contents */
+	uint64_t hash = 0;
+
+	/** Last modification of the file, in nanoseconds of the file clock */
+	int64_t modified = 0;
+
+	/** Bytes in the file */
+	uint32_t size = 0;
+
+	/** Dedup group, equal for files with equal contents and numbered from 0 in path order */
+	uint32_t group = 0;
+
+	/** Platform from detect_platform, and its recommended quirks and speed */
+	Platform platform = Platform::CHIP8;
+	uint8_t quirks = 0;
+	uint16_t instructions_per_frame = 0;
+
+	/** From the sidecar's "Title :" style lines, else from a file name like "Brix [Andreas Gustafsson, 1990].ch8" */
+	std::string title, author, date, system;
+
+	/** Whole sidecar text, empty without one */
+	std::string notes;
+};
+
+/**
+ * @brief Offset and length of a string in the index's string pool
+ */
+struct CatalogueString
+{
+	uint32_t offset, length;
+};
+
+/**
+ * @brief One rom in the index file, the fields of a CatalogueRecord at fixed offsets
+ */
+struct CatalogueEntry
+{
+	uint64_t hash;
+	int64_t modified;
+	uint32_t size;
+	uint32_t group;
+	Platform platform;
+	uint8_t quirks;
+	uint16_t instructions_per_frame;
+	uint32_t reserved;
+	CatalogueString path, title, author, date, system, notes;
+};
+
+/**
+ * @brief Start of an index file
+ *
+ * @details Followed by the entries sorted by path, the entry numbers sorted by hash, and the string pool.
+ */
+struct CatalogueHeader
+{
+	/** Tells index files apart from anything else */
+	static constexpr char MAGIC[4] = {'C', '8', 'C', 'I'};
+
+	/** Bumped whenever the layout changes */
+	static constexpr uint32_t VERSION = 1;
+
+	char magic[4];
+	uint32_t version;
+
+	/** Roms, and distinct contents among them */
+	uint32_t entries, groups;
+
+	/** Bytes in the string pool */
+	uint32_t pool;
+
+	/** Corpus directory the paths are under, as given to the scan */
+	CatalogueString root;
+
+	uint8_t reserved[36];
+};
+
+static_assert(sizeof(CatalogueEntry) == 80, "Index entries are a fixed 80 bytes");
+static_assert(sizeof(CatalogueHeader) == 64, "Index headers are a fixed 64 bytes");
+
+/**
+ * @brief Scan a rom corpus: hash, platform and sidecar notes of every file that is not a .txt
+ *
+ * @details A sidecar is the .txt with the rom's file name, or without a trailing " (alt)". Files that
+ * 			are no rom are logged and left out.
+ *
+ * @param rom_dir corpus directory, scanned recursively
+ * @param records filled with one record per rom, sorted by path and grouped by content
+ * @return true If the directory could be read. Else, false.
+ */
+bool scan_corpus(const std::string &rom_dir, std::vector<CatalogueRecord> &records);
+
+/**
+ * @brief Write an index file
+ *
+ * @param path index file to replace
+ * @param root corpus directory the records were scanned from
+ * @param records records from scan_corpus
+ * @return true If the whole index was written. Else, false.
+ */
+bool write_catalogue(const std::string &path, const std::string &root, const std::vector<CatalogueRecord> &records);
+
+/**
+ * @brief Read only view of an index file
+ *
+ * @details Opening maps the file and checks its header, nothing is parsed, so batch tools start in
+ * 			constant time whatever the corpus size. Strings point into the mapping.
+ */
+class Catalogue
+{
+
+  public:
+	/**
+	 * @brief Factory method
+	 *
+	 * @param path index file written by write_catalogue
+	 * @return std::unique_ptr<Catalogue> open index, null when the file can not be read or is no index
+	 */
+	static std::unique_ptr<Catalogue> open_catalogue(const std::string &path);
+
+	/** Destructor, unmaps the file */
+	~Catalogue(void);
+
+	Catalogue(const Catalogue &) = delete;
+	Catalogue &operator=(const Catalogue &) = delete;
+
+	/**
+	 * @brief Roms in the index
+	 *
+	 * @return size_t entry count
+	 */
+	size_t size(void) const { return m_header->entries; }
+
+	/**
+	 * @brief Distinct contents among the roms
+	 *
+	 * @return size_t dedup group count
+	 */
+	size_t groups(void) const { return m_header->groups; }
+
+	/**
+	 * @brief Entry by position, entries are sorted by path
+	 *
+	 * @param i position, below size()
+	 * @return const CatalogueEntry& entry
+	 */
+	const CatalogueEntry &operator[](const size_t &i) const { return m_entries[i]; }
+
+	/**
+	 * @brief Text of a string in the pool
+	 *
+	 * @param string string of an entry or the header
+	 * @return std::string_view text, empty when it lies outside the pool
+	 */
+	std::string_view text(const CatalogueString &string) const;
+
+	/**
+	 * @brief Corpus directory the paths are under
+	 *
+	 * @return std::string_view directory given to the scan
+	 */
+	std::string_view root(void) const { return text(m_header->root); }
+
+	/**
+	 * @brief Look a rom up by path, a binary search
+	 *
+	 * @param path path under the corpus root
+	 * @return const CatalogueEntry* entry, null when not indexed
+	 */
+	const CatalogueEntry *find(std::string_view path) const;
+
+	/**
+	 * @brief Look a rom up by content, a binary search
+	 *
+	 * @param hash rom_hash of the contents
+	 * @return const CatalogueEntry* first entry with the contents in path order, null when not indexed
+	 */
+	const CatalogueEntry *find(const uint64_t &hash) const;
+
+	/**
+	 * @brief Whether the file behind an entry changed since the scan, by its size and modification time
+	 *
+	 * @param entry entry of this index
+	 * @return true If the file is gone or differs. Else, false.
+	 */
+	bool stale(const CatalogueEntry &entry) const;
+
+  private:
+	/** Private constructor to enforce unique pointer factory methods */
+	Catalogue(void);
+
+	/** Sections of the file */
+	const CatalogueHeader *m_header;
+	const CatalogueEntry *m_entries;
+	const uint32_t *m_by_hash;
+	const char *m_pool;
+
+	/** Heap copy of the file when it can not be mapped */
+	std::vector<char> m_storage;
+
+	/** Mapping to release, zero bytes when on the heap */
+	void *m_mapping;
+	size_t m_mapped_bytes;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_CATALOGUE_H
@@ -2,10 +2,15 @@
 #define GRAPHICS_SDL2_HPP
 
 #include <string>
+#include <array>
+#include <bit>
+#include <chrono>
 
 #include "SDL2/SDL.h"
 #include "Singleton.h"
 #include "Logger.h"
+#include "Interpreter.h"
+#include "Scheduler.h"
 
 /*!
  *  \addtogroup chip8
@@ -32,7 +37,9 @@ public:
         p_window = NULL;
         p_renderer = NULL;
         p_texture = NULL;
-        key_state = {};
+        rewind_held = false;
+        profile_requested = false;
+        pixels = {};
     }
 
     /**
@@ -48,6 +55,9 @@ public:
             exit(1);
         }
 
+        // Steady clock time of SDL tick 0
+        ticks_epoch = std::chrono::steady_clock::now() - std::chrono::milliseconds(SDL_GetTicks());
+
         // Initialize window
         init_window();
         // Initialize renderer and texture
@@ -55,61 +65,110 @@ public:
     }
 
     /**
-     * @brief Monitor key events for chip8 controller inputs
+     * @brief Queue chip8 key transitions, stamped with the time SDL saw them
+     * 
+     * @details Call from the thread that called init, once per display frame.
      * 
-     * @return std::array<bool, 16> state of all chip8 inputs. True means pressed, else false.
+     * @param queue transitions for the emulation thread. Ones that do not fit are dropped
+     * @return true If the user asked to quit. Else, false.
      */
-    std::array<bool, 16> check_events()
+    bool pump_events( InputQueue& queue )
     {
+        bool quit = false;
+
         SDL_Event e;
-		while(SDL_PollEvent(&e))
-		{
-            // On keydown, set key state if is chip8 controller input
-			if(e.type == SDL_KEYDOWN)
-			{
-				if(e.key.keysym.sym == SDLK_ESCAPE)
-				{
-					util::LOG(LOGTYPE::ERROR, "Exiting program");
-					exit(0);
-				}
-
-				for (int i = 0; i < 16; ++i)
-				{
-					if (e.key.keysym.sym == key_types[i])
-					{
-						key_state[i] = true;
-					}
-				}
-			}
-            // On keyup, clear key state if is chip8 controller input
-			else if(e.type == SDL_KEYUP)
-			{
-				for (int i = 0; i < 16; ++i)
-				{
-					if (e.key.keysym.sym == key_types[i])
-					{
-						key_state[i] = false;
-					}
-				}
-			}
-		}
-
-        // Return key state
-        return key_state;
+        while(SDL_PollEvent(&e))
+        {
+            if(e.type == SDL_QUIT || (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE))
+            {
+                util::LOG(LOGTYPE::ERROR, "Exiting program");
+                quit = true;
+                continue;
+            }
+
+            // Held keys repeat key downs, only transitions matter
+            if((e.type != SDL_KEYDOWN && e.type != SDL_KEYUP) || e.key.repeat != 0)
+                continue;
+
+            if(e.key.keysym.sym == SDLK_BACKSPACE)
+            {
+                rewind_held = e.type == SDL_KEYDOWN;
+                continue;
+            }
+
+            if(e.key.keysym.sym == SDLK_F9)
+            {
+                profile_requested |= e.type == SDL_KEYDOWN;
+                continue;
+            }
+
+            for (uint8_t i = 0; i < 16; ++i)
+            {
+                if (e.key.keysym.sym == key_types[i])
+                {
+                    // SDL timestamps are milliseconds since SDL_Init, move them onto the steady clock
+                    const auto time = ticks_epoch + std::chrono::milliseconds(e.key.timestamp);
+                    if (!queue.push({ time, i, e.type == SDL_KEYDOWN }))
+                        util::LOG(LOGTYPE::ERROR, "Input queue full, dropping a key transition");
+                }
+            }
+        }
+
+        return quit;
+    }
+
+    /**
+     * @brief Rewind key state as of the last pump_events
+     * 
+     * @return true If backspace is held. Else, false.
+     */
+    bool rewinding( void ) const { return rewind_held; }
+
+    /**
+     * @brief Whether F9 was pressed since the last call
+     * 
+     * @return true If a profile report was asked for. Else, false.
+     */
+    bool take_profile_request( void )
+    {
+        const bool requested = profile_requested;
+        profile_requested = false;
+        return requested;
     }
 
     /**
-     * @brief Update sdl texture and render on screen
+     * @brief Upload the rows changed since the last present and render on screen
+     * 
+     * @details Each run of consecutive dirty rows is expanded to ARGB and uploaded with one rect update.
+     *          Call at most once per display frame, draws in between only add dirty rows.
+     *          The texture is allocated once at the high resolution size, a smaller screen uses its top left corner.
      * 
-     * @param screen array of pixels defining chip8 screen state of 64x32
+     * @param frame screen view from Interpreter::frame, clear its dirty rows afterwards
      */
-    void update_texture( std::array<uint32_t, 64 * 32> screen )
+    void present( const Interpreter::FrameView& frame )
     {
-        util::LOG(LOGTYPE::DEBUG, "Draw flag set, prepping screen state for texture update");
-        // Magic numbers to fix
-        SDL_UpdateTexture(p_texture, NULL, screen.data(), 64*sizeof(uint32_t));
+        util::LOG<LOGTYPE::DEBUG>([]{ return std::string("Presenting dirty screen rows"); });
+
+        const int width = frame.width;
+        uint64_t dirty = frame.height < 64 ? frame.dirty & ((uint64_t(1) << frame.height) - 1) : frame.dirty;
+        while (dirty != 0)
+        {
+            const int first = std::countr_zero(dirty);
+            const int count = std::countr_one(dirty >> first);
+
+            for (int y = first; y < first + count; ++y)
+                for (int x = 0; x < width; ++x)
+                    pixels[y * width + x] = (frame.rows[y][x / 64] >> (63 - x % 64)) & 1 ? 0xFFFFFFFF : 0;
+
+            const SDL_Rect rect = { 0, first, width, count };
+            SDL_UpdateTexture(p_texture, &rect, &pixels[first * width], width * sizeof(uint32_t));
+
+            dirty &= count == 64 ? 0 : ~(((uint64_t(1) << count) - 1) << first);
+        }
+
+        const SDL_Rect screen = { 0, 0, width, frame.height };
         SDL_RenderClear(p_renderer);
-        SDL_RenderCopy(p_renderer, p_texture, NULL, NULL);
+        SDL_RenderCopy(p_renderer, p_texture, &screen, NULL);
         SDL_RenderPresent(p_renderer);	
     }
 
@@ -122,8 +181,16 @@ private:
                                                     SDLK_q, SDLK_w, SDLK_e, SDLK_a, 
                                                     SDLK_s, SDLK_d, SDLK_z, SDLK_c, 
                                                     SDLK_4, SDLK_r, SDLK_f, SDLK_v,};
-    // Chip8 controller key states
-    std::array<bool, 16> key_state;
+    // Backspace held
+    bool rewind_held;
+    // F9 pressed since the last take_profile_request
+    bool profile_requested;
+
+    // Steady clock time SDL event timestamps count from
+    std::chrono::steady_clock::time_point ticks_epoch;
+
+    // ARGB staging for dirty rows, rows are the screen's width apart
+    std::array<uint32_t, HIRES_WIDTH * HIRES_HEIGHT> pixels;
 
     // SDL variables
     SDL_Window*     p_window;
@@ -153,15 +220,15 @@ private:
     void init_texture()
     {
         // SDL Rendereder
-        p_renderer = SDL_CreateRenderer(p_window, -1, 0);
+        p_renderer = SDL_CreateRenderer(p_window, -1, SDL_RENDERER_PRESENTVSYNC);
         SDL_RenderSetLogicalSize(p_renderer, SDL_SCRN_WIDTH, SDL_SCRN_HEIGHT);
 
-        // Create a texture. want ARGB 8888 renderer meaning uint32_t elements
+        // Create a texture. want ARGB 8888 renderer meaning uint32_t elements. Large enough for every resolution
         p_texture = SDL_CreateTexture( p_renderer, 
                                                 SDL_PIXELFORMAT_ARGB8888,
                                                 SDL_TEXTUREACCESS_STREAMING,
-                                                64,
-                                                32);
+                                                HIRES_WIDTH,
+                                                HIRES_HEIGHT);
     }
 };
 
@@ -0,0 +1,119 @@
+#ifndef CHIP8_HEADLESS_H
+#define CHIP8_HEADLESS_H
+
+// Project includes
+#include "Interpreter.h"	// Interpreter to run
+
+// C++ includes
+#include <array>	// Screen
+#include <cstdint>	// Fixed width integers
+#include <iosfwd>	// Stream declarations
+#include <string>	// Error messages
+#include <vector>	// Input scripts
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Scripted key transition, applied before the first instruction of a frame
+ */
+struct KeyEvent
+{
+	/** Frame the transition happens on */
+	uint64_t frame;
+
+	/** Chip8 key 0x0 to 0xF */
+	uint8_t key;
+
+	/** True for key down, false for key up */
+	bool pressed;
+};
+
+/**
+ * @brief Limits for a headless run. A zero limit is not checked
+ */
+struct RunLimits
+{
+	/** Maximum number of instructions to execute */
+	uint64_t max_cycles = 0;
+
+	/** Maximum number of frames to execute */
+	uint64_t max_frames = 0;
+
+	/** Instructions executed per 60 Hz frame */
+	unsigned int instructions_per_frame = 10;
+
+	/** Stop once the program counter stops moving and no scripted input is left to free it */
+	bool stop_on_loop = true;
+};
+
+/**
+ * @brief Reason a headless run stopped
+ */
+enum class StopReason { CYCLES, FRAMES, PC_LOOP, EXIT };
+
+/**
+ * @brief Statistics of a finished headless run
+ */
+struct RunStats
+{
+	/** Instructions executed */
+	uint64_t cycles = 0;
+
+	/** Frames started */
+	uint64_t frames = 0;
+
+	/** Host wall clock time of the run in seconds */
+	double seconds = 0.0;
+
+	/** Why the run stopped */
+	StopReason reason = StopReason::CYCLES;
+};
+
+/**
+ * @brief Parse an input script. One "<frame> <key hex> <down|up>" transition per line, # starts a comment
+ * 
+ * @param in stream holding the script
+ * @param events parsed transitions, sorted by frame
+ * @param error description of the first bad line
+ * @return true If the whole script parsed. Else, false.
+ */
+bool parse_input_script(std::istream &in, std::vector<KeyEvent> &events, std::string &error);
+
+/**
+ * @brief Run an interpreter at full host speed until a limit, a program counter loop or the exit flag
+ * 
+ * @param interpreter interpreter with a rom loaded
+ * @param limits cycle and frame limits
+ * @param script key transitions sorted by frame
+ * @return RunStats statistics of the run
+ */
+RunStats run_headless(Interpreter &interpreter, const RunLimits &limits, const std::vector<KeyEvent> &script);
+
+/**
+ * @brief Write a screen as a plain PBM image, lit pixels are black
+ * 
+ * @param out stream to write to
+ * @param frame screen view from Interpreter::frame, written at its size
+ */
+void write_pbm(std::ostream &out, const Interpreter::FrameView &frame);
+
+/**
+ * @brief Name of a stop reason
+ * 
+ * @param reason stop reason
+ * @return const char* lower case name
+ */
+const char *to_string(StopReason reason);
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_HEADLESS_H
@@ -3,11 +3,20 @@
 
 // Project includes
 #include "Memory.h"	// For memory map
+#include "Platform.h"	// Quirk flags
+#include "Random.h"	// Cxnn random numbers
+#include "SaveState.h"	// State snapshots
+#include "Trace.h"		// Instruction trace ring
 
 // C++ includes
 #include <array>	// C++ array
 #include <stack>	// C++ stack
 #include <memory> 	// Memory for unique ptr
+#include <span>		// Byte spans for memory stores
+#include <cstdint>	// Fixed width integers
+#include <iosfwd>	// Profile reports
+#include <string>	// Disassembly
+#include <vector>	// Expanded screen pixels
 
 /*!
  *  \addtogroup chip8
@@ -23,15 +32,35 @@ namespace
 {
 	constexpr size_t MEM_SPACE = 0x0FFF;   // Const for denoting size of memory map
 	constexpr long  FONT_START = 0x0000;   // Const for denoting start of Chip8 program
+	constexpr long  BIG_FONT_START = 0x0050;   // SUPER-CHIP 8x10 digits follow the small font
 	constexpr long  PROG_START = 0x0200;   // Const for denoting start of Chip8 program
 	constexpr uint8_t SCRN_WIDTH = 64;
   	constexpr uint8_t SCRN_HEIGHT = 32;
+	constexpr uint8_t HIRES_WIDTH = 128;   // SUPER-CHIP high resolution
+	constexpr uint8_t HIRES_HEIGHT = 64;
 }
 
+/** Screen row of up to 128 pixels in two words, the most significant bit of the first word is x = 0 */
+using ScreenRow = std::array<uint64_t, 2>;
+
+/** Every row of the largest screen. Smaller screens use the first rows, 64 pixel wide ones only the first word */
+using ScreenRows = std::array<ScreenRow, HIRES_HEIGHT>;
+
+class Recompiler;
+
+/** Every leaf opcode handler, used to build the handler table and the dispatch labels */
+#define CHIP8_OPCODES(X) \
+	X(00E0) X(00EE) X(00Cn) X(00FB) X(00FC) X(00FD) X(00FE) X(00FF) X(1nnn) X(2nnn) X(3xnn) X(4xnn) X(5xy0) X(6xnn) X(7xnn) \
+	X(8xy0) X(8xy1) X(8xy2) X(8xy3) X(8xy4) X(8xy5) X(8xy6) X(8xy7) X(8xyE) \
+	X(9xy0) X(Annn) X(Bxnn) X(Cxnn) X(Dxyn) X(Ex9E) X(ExA1) \
+	X(Fx07) X(Fx0A) X(Fx15) X(Fx18) X(Fx1E) X(Fx29) X(Fx30) X(Fx33) X(Fx55) X(Fx65) X(Fx75) X(Fx85) X(unknown)
+
 /**
  * @brief Chip8 interpreter class. Used to handle all chip8 functionality
+ * 
+ * @details Cache line aligned so instances running on different threads never share a line.
  */
-class Interpreter
+class alignas(64) Interpreter
 {
 
   public:
@@ -43,11 +72,184 @@ class Interpreter
 	 */
 	static std::unique_ptr<Interpreter> make_interpreter(std::unique_ptr<MemoryMap> memory);
 
+	/** Destructor, defined where the recompiler is complete */
+	~Interpreter(void);
+
 	/**
 	 * @brief Interpret next instruction
 	 */
 	void next_instruction(void);
 
+	/**
+	 * @brief Reason a batch run returned
+	 */
+	enum class RunResult { CYCLES, DRAW, KEY_WAIT, EXIT };
+
+	/**
+	 * @brief Execute up to cycles instructions in one call
+	 * 
+	 * @details Returns early when the exit flag is set or when Fx0A is waiting on a key.
+	 * 			The program counter is left on the Fx0A so the next run retries it.
+	 * 
+	 * @param cycles maximum number of instructions to execute
+	 * @return RunResult CYCLES once the budget is used, else why it stopped early
+	 */
+	RunResult run_cycles(const uint64_t &cycles);
+
+	/**
+	 * @brief Execute until a draw instruction sets the draw flag, at most max_cycles instructions
+	 * 
+	 * @details Same early returns as run_cycles. The draw flag is left set for draw() to consume,
+	 * 			a flag still set from earlier stops the run after one instruction.
+	 * 
+	 * @param max_cycles maximum number of instructions to execute
+	 * @return RunResult DRAW on a draw, else why it stopped
+	 */
+	RunResult run_until_frame(const uint64_t &max_cycles);
+
+	/**
+	 * @brief Switch run_cycles and run_until_frame between the interpreter and the x86-64 recompiler
+	 * 
+	 * @details The recompiler needs flat memory and an x86-64 host, otherwise the interpreter stays in use.
+	 * 
+	 * @param enable true to translate blocks, false to interpret
+	 * @return true If the recompiler is now in use. Else, false.
+	 */
+	bool enable_jit(const bool &enable);
+
+	/**
+	 * @brief Recompiler getter
+	 * 
+	 * @return true If batch runs use the recompiler. Else, false.
+	 */
+	bool jit(void) const { return m_jit != nullptr; }
+
+	/**
+	 * @brief Executed instruction counter getter
+	 * 
+	 * @return uint64_t Instructions executed since the last reset
+	 */
+	uint64_t cycles(void) const { return m_cycle_count; }
+
+	/**
+	 * @brief Reset registers, timers, stack, keys, screen, RPL flags and flags to their power on state
+	 * 
+	 * @details Memory is left untouched so an instance can be reused after loading a new rom into it.
+	 * 			Predecoded instructions are dropped, so call this after changing memory from outside.
+	 * 			A rom starting with a jump to 0x260 is a VIP two page rom, it starts at 0x2C0 with a 64x64 screen.
+	 */
+	void reset(void);
+
+	/**
+	 * @brief Count executions per opcode handler and per guest address, or stop counting
+	 * 
+	 * @details Turning it on clears the counts. While it is on, batch runs interpret instead of using
+	 * 			the recompiler, and the interpreter loop is a separate instantiation so it costs nothing when off.
+	 * 
+	 * @param enable true to start counting, false to stop and drop the counts
+	 */
+	void enable_profiling(const bool &enable);
+
+	/**
+	 * @brief Profiling getter
+	 * 
+	 * @return true If executions are being counted. Else, false.
+	 */
+	bool profiling(void) const { return m_profile != nullptr; }
+
+	/**
+	 * @brief Record every executed instruction into a trace ring, or stop recording
+	 * 
+	 * @details While a ring is set, batch runs interpret instead of using the recompiler.
+	 * 
+	 * @param ring ring to record into, null to stop
+	 */
+	void set_trace(std::unique_ptr<TraceRing> ring) { m_trace = std::move(ring); }
+
+	/**
+	 * @brief Trace ring getter
+	 * 
+	 * @return const TraceRing* ring being recorded into, null when not tracing
+	 */
+	const TraceRing *trace(void) const { return m_trace.get(); }
+
+	/**
+	 * @brief Pick the behaviour of the opcodes CHIP-8 interpreters disagree on
+	 * 
+	 * @details Every quirk set has its own compiled handlers and interpreter loop, so the handlers never
+	 * 			branch on a quirk. Survives reset, pick it once per rom, e.g. from platform_profile.
+	 * 
+	 * @param quirks one of the QuirkSet values
+	 * @return true If the set is compiled in and now in use. Else, false and the quirks are unchanged.
+	 */
+	bool set_quirks(const uint8_t &quirks);
+
+	/**
+	 * @brief Quirk set getter
+	 * 
+	 * @return uint8_t Quirk flags in use, QUIRKS_NONE until set_quirks is called
+	 */
+	uint8_t quirks(void) const { return m_quirks; }
+
+	/**
+	 * @brief Write a hot spot report: opcode handlers by executions, then the hottest addresses with their disassembly
+	 * 
+	 * @param out stream to write to
+	 * @param top number of addresses to list
+	 */
+	void write_profile(std::ostream &out, const size_t &top = 20) const;
+
+	/**
+	 * @brief Disassemble an opcode with Cowgod's mnemonics, e.g. DRW V0, V1, 5
+	 * 
+	 * @param opcode 16 bit opcode
+	 * @return std::string mnemonic and operands
+	 */
+	static std::string disassemble(const unsigned int &opcode);
+
+	/**
+	 * @brief Capture the complete state, memory included
+	 * 
+	 * @param state filled with this interpreter's state
+	 * @return true If it was captured. Else, false when memory is not flat.
+	 */
+	bool save_state(SaveState &state) const;
+
+	/**
+	 * @brief Continue from a captured state
+	 * 
+	 * @details The quirk set is restored too. Predecoded instructions and translated blocks are dropped.
+	 * 			Nothing changes when the state is rejected.
+	 * 
+	 * @param state state from save_state or read_state
+	 * @return true If it was restored. Else, false for a bad header, stack pointer, screen size or quirk set, or memory that is not flat.
+	 */
+	bool load_state(const SaveState &state);
+
+	/**
+	 * @brief Seed the random number generator used by Cxnn and restart its sequence
+	 * 
+	 * @details The seed survives reset, which restarts the same sequence. Defaults to DEFAULT_SEED.
+	 * 
+	 * @param seed any value, equal seeds replay equal runs
+	 */
+	void seed(const uint64_t &seed);
+
+	/**
+	 * @brief Seed getter
+	 * 
+	 * @return uint64_t seed set by the last call to seed
+	 */
+	uint64_t seed(void) const { return m_seed; }
+
+	/** Seed used until seed is called */
+	static constexpr uint64_t DEFAULT_SEED = 0x5EED;
+
+	/**
+	 * @brief Count the delay and sound timers down by one, call it once per 60 Hz frame
+	 */
+	void tick_timers(void);
+
 	/**
 	 * @brief Delay timer getter
 	 * 
@@ -62,19 +264,100 @@ class Interpreter
 	 */
 	unsigned int sound(void) const { return m_sound_timer; }
 
+	/**
+	 * @brief Program counter getter
+	 * 
+	 * @return unsigned int Address of the next instruction
+	 */
+	unsigned int pc(void) const { return m_program_counter; }
+
+	/**
+	 * @brief Memory map getter
+	 * 
+	 * @return const MemoryMap& Memory the interpreter runs from
+	 */
+	const MemoryMap &memory(void) const { return *memory_map; }
+
 	/**
 	 * @brief Get array representing the screen
 	 * 
-	 * @return std::array<uint32_t, 64 * 32> Array of pixels that are either on or off 
+	 * @details Expands the packed rows into ARGB pixels, call it when presenting a frame.
+	 * 
+	 * @return std::vector<uint32_t> width() * height() pixels that are either on or off, row by row
+	 */
+	std::vector<uint32_t> screen(void) const;
+
+	/**
+	 * @brief Screen width getter
+	 * 
+	 * @return unsigned int 64, or 128 after 00FF switched to high resolution
+	 */
+	unsigned int width(void) const { return m_width; }
+
+	/**
+	 * @brief Screen height getter
+	 * 
+	 * @return unsigned int 32, or 64 in high resolution and for VIP two page roms
 	 */
-	std::array<uint32_t, 64 * 32> screen(void) { return m_pixels; }
+	unsigned int height(void) const { return m_height; }
+
+	/**
+	 * @brief Const view of the screen, valid until the interpreter runs again
+	 */
+	struct FrameView
+	{
+		/** Packed rows, only the first height rows and width pixels of each are on screen */
+		const ScreenRows &rows;
+
+		/** Bumped whenever any row or the resolution changes */
+		uint64_t generation;
+
+		/** Rows changed since the last clear_dirty, bit y is row y. All of them after a resolution change */
+		uint64_t dirty;
+
+		/** Screen size in pixels */
+		uint8_t width, height;
+	};
+
+	/**
+	 * @brief Screen view getter. Copies nothing but the counters
+	 * 
+	 * @return FrameView View of the rows with their generation, dirty rows and size
+	 */
+	FrameView frame(void) const { return { m_rows, m_frame_generation, m_dirty_rows, m_width, m_height }; }
+
+	/**
+	 * @brief Forget the dirty rows, call it once a frame has been presented
+	 */
+	void clear_dirty(void) { m_dirty_rows = 0; }
+
+	/**
+	 * @brief Packed screen getter
+	 * 
+	 * @return const ScreenRows& Two words per row, the most significant bit of the first is x = 0
+	 */
+	const ScreenRows &rows(void) const { return m_rows; }
 
 	/**
 	 * @brief Update the key state based on gui input
 	 * 
 	 * @param t_keys Array of key states for chip8 controller
 	 */
-	void sync_keys(std::array<bool, 16> t_keys) { this->m_keys = t_keys; }
+	void sync_keys(std::array<bool, 16> t_keys);
+
+	/**
+	 * @brief Set every key at once
+	 * 
+	 * @param mask bit k is set while key k is down
+	 */
+	void set_key_mask(const uint16_t &mask) { m_key_mask = mask; }
+
+	/**
+	 * @brief Key state getter
+	 * 
+	 * @return uint16_t bit k is set while key k is down
+	 */
+	uint16_t key_mask(void) const { return m_key_mask; }
 
 	/**
 	 * @brief Get exit flag
@@ -106,17 +389,74 @@ class Interpreter
 	/** Interpreter's memory map to pull instructions from */
 	std::unique_ptr<MemoryMap> memory_map;
 
+	/** Non-owning view of memory_map when it is flat. Null for any other memory map */
+	FlatMemory* m_ram;
+
+	/** Read a byte, skipping the virtual call when memory is flat */
+	std::byte mem_read(const unsigned int &adr) const { return m_ram ? m_ram->fetch(adr) : memory_map->read(adr); }
+
+	/** Store a block of bytes starting at adr and drop any predecoded instruction they overlap */
+	void mem_store(const unsigned int &adr, std::span<const std::byte> bytes);
+
 	/** Flag for exit and draw */
 	bool m_exit_flag, m_draw_flag;
 
+	/** Set by Fx0A when it has to wait for a key */
+	bool m_key_wait;
+
+	/** Instructions executed since reset */
+	uint64_t m_cycle_count;
+
+	/** Batch run shared by run_cycles and run_until_frame */
+	RunResult run(uint64_t cycles, const bool &stop_on_draw);
+
+	/** Threaded dispatch loop over predecoded instructions, also the recompiler's fallback */
+	RunResult interpret(uint64_t cycles, const bool &stop_on_draw);
+
+	/** Translates blocks when enabled, generated code works on this object's state directly */
+	std::unique_ptr<Recompiler> m_jit;
+	friend class Recompiler;
+
 	/** Timers, index register, program counter */
 	unsigned int m_delay_timer, m_sound_timer, m_index_register, m_program_counter;
 
-	/** Screen */
-	std::array<uint32_t, 64 * 32> m_pixels;
+	/** Screen, one bit per pixel with the most significant bit of a row at x = 0. Rows are whole words so scrolls are word shifts */
+	ScreenRows m_rows;
+	static_assert(SCRN_WIDTH == 64 && HIRES_WIDTH == 128, "A low resolution row has to fit one word and a high resolution row two");
+
+	/** Screen size in use */
+	uint8_t m_width, m_height;
+
+	/** Running a VIP two page rom, whose interpreter patch turns 0230 into a clear screen */
+	bool m_two_page;
+
+	/** Screen changes since construction, and rows changed since the last clear_dirty */
+	uint64_t m_frame_generation;
+	uint64_t m_dirty_rows;
+	static_assert(HIRES_HEIGHT <= 64, "Every row needs a dirty bit");
+
+	/** Switch the screen size and clear the screen */
+	void set_resolution(const uint8_t &width, const uint8_t &height);
 
-	/** Key pressed state */
-	std::array<bool, 16> m_keys;
+	/** Mark rows dirty and count a screen change */
+	void touch_rows(const uint64_t &dirty)
+	{
+		if (dirty)
+		{
+			m_dirty_rows |= dirty;
+			++m_frame_generation;
+		}
+	}
+
+	/** Dirty bits of every row with a lit pixel */
+	uint64_t lit_rows(void) const;
+
+	/** Key pressed state, bit k for key k */
+	uint16_t m_key_mask;
+
+	/** Random number generator for Cxnn and the seed reset restarts it from */
+	Pcg32 m_random;
+	uint64_t m_seed;
 
 	/** Register values */
 	std::array<uint8_t, 16> m_registers;
@@ -124,27 +464,128 @@ class Interpreter
 	/** Subroutine stack */
 	unsigned int m_sp;
 	std::array<uint16_t, 16> m_stack;
+
+	/** SUPER-CHIP's HP48 RPL user flags, saved and loaded by Fx75 and Fx85 */
+	std::array<uint8_t, 16> m_rpl;
 	
 	/** CPU OPCODE FUNCTION DEFINITIONS BELOW */
-	typedef void (*OpcodeTable)(Interpreter *cpu, const unsigned int &opcode);
-
-	OpcodeTable opcodes[16];
-	static void opcode_0xxx(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_1nnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_2nnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_3xnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_4xnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_5xy0(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_6xnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_7xnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_8XYx(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_9xy0(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_Annn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_Bxnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_Cxnn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_Dxyn(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_EXxx(Interpreter *cpu, const unsigned int &opcode);
-	static void opcode_FXxx(Interpreter *cpu, const unsigned int &opcode);
+	struct Instruction;
+	typedef void (*Handler)(Interpreter *cpu, const Instruction &op);
+
+	/** Leaf handler index. OP_DECODE marks an entry that still has to be decoded */
+	enum Op : uint8_t
+	{
+		OP_DECODE,
+#define X(name) OP_##name,
+		CHIP8_OPCODES(X)
+#undef X
+		OP_COUNT
+	};
+
+	/** Opcode decoded once into its handler index and operand fields */
+	struct Instruction
+	{
+		uint16_t opcode;
+		uint16_t nnn;
+		uint8_t kind;
+		uint8_t x, y, n, nn;
+	};
+
+	/** Handler for every Op in a quirk set, OP_DECODE has none */
+	template <uint8_t QUIRKS>
+	static const Handler handlers[OP_COUNT];
+
+	/** Quirk flags in use and the handler table built for them */
+	uint8_t m_quirks;
+	const Handler *m_handlers;
+
+	/** Handler table of a quirk set, null when the set is not compiled in */
+	static const Handler *quirk_handlers(const uint8_t &quirks);
+
+	/** Decode an opcode into its handler index and fields. 0230 only clears the screen for two page roms */
+	static Instruction decode(const unsigned int &opcode, const bool &two_page = false);
+
+	/** Predecoded instruction for every even and odd address. Only used with flat memory */
+	std::unique_ptr<std::array<Instruction, FlatMemory::SIZE>> m_decoded;
+
+	/** Drop predecoded instructions overlapping [adr, adr + size) */
+	void invalidate(const unsigned int &adr, const size_t &size);
+
+	/** Executions per handler and per address while profiling */
+	struct Profile
+	{
+		std::array<uint64_t, OP_COUNT> ops;
+		std::array<uint64_t, FlatMemory::SIZE> pcs;
+	};
+	std::unique_ptr<Profile> m_profile;
+
+	/** Count one execution of a handler at an address */
+	void profile(const uint8_t &kind, const unsigned int &adr) { ++m_profile->ops[kind]; ++m_profile->pcs[adr & FlatMemory::ADR_MASK]; }
+
+	/** Instructions are recorded here while tracing */
+	std::unique_ptr<TraceRing> m_trace;
+
+	/** Record an executed instruction fetched from an address */
+	void trace(const Instruction &op, const unsigned int &adr)
+	{
+		m_trace->record({ m_cycle_count, (uint16_t)adr, op.opcode, (uint16_t)m_index_register, op.x, m_registers[op.x] });
+	}
+
+	/** Instrumentation compiled into an instantiation of the interpreter loop */
+	enum Hooks : unsigned int { HOOK_NONE = 0, HOOK_PROFILE = 1, HOOK_TRACE = 2 };
+
+	/** Interpreter loop, instantiated for every combination of hooks and every quirk set */
+	template <unsigned int HOOKS, uint8_t QUIRKS>
+	RunResult dispatch(uint64_t cycles, const bool &stop_on_draw);
+
+	/** Pick the loop of the quirk set in use */
+	template <unsigned int HOOKS>
+	RunResult dispatch_quirks(uint64_t cycles, const bool &stop_on_draw);
+
+	template <uint8_t QUIRKS> static void opcode_00E0(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00EE(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00Cn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00FB(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00FC(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00FD(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00FE(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_00FF(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_1nnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_2nnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_3xnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_4xnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_5xy0(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_6xnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_7xnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy0(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy1(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy2(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy3(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy4(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy5(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy6(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xy7(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_8xyE(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_9xy0(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Annn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Bxnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Cxnn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Dxyn(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Ex9E(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_ExA1(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx07(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx0A(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx15(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx18(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx1E(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx29(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx30(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx33(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx55(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx65(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx75(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_Fx85(Interpreter *cpu, const Instruction &op);
+	template <uint8_t QUIRKS> static void opcode_unknown(Interpreter *cpu, const Instruction &op);
 };
 
 } // namespace chip8
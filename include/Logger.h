@@ -4,6 +4,24 @@
 // C++ includes
 #include <string>
 #include <iomanip>
+#include <utility>
+#include <atomic>
+#include <memory>
+#include <iosfwd>
+
+/**
+ * @brief Lowest log level compiled in. Messages below it are removed at compile time.
+ * 
+ * @details Defaults to DEBUG (0) and to ERROR (1) when NDEBUG is defined, so release
+ * 			builds carry no per opcode trace code at all. Override with -DCHIP8_MIN_LOG_LEVEL=n.
+ */
+#ifndef CHIP8_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define CHIP8_MIN_LOG_LEVEL 1
+#else
+#define CHIP8_MIN_LOG_LEVEL 0
+#endif
+#endif
 
 /*!
  *  \addtogroup util
@@ -16,6 +34,11 @@ namespace util
 
 /**
  * @brief Logger class used to log messages at different severity levels
+ * 
+ * @details Thread safe. Logging copies the message into a fixed size record on a lock free queue and returns,
+ * 			a background thread writes the records in batches. The writer collapses runs of identical messages
+ * 			into a repeat count and writes at most LINES_PER_SECOND lines a second, counting the rest.
+ * 			A full queue drops the message instead of waiting, the drops are reported too.
  */
 class Logger
 {
@@ -26,6 +49,12 @@ public:
 	 */
 	enum class LOG_LEVEL{DEBUG, ERROR, NONE};
 
+	/** Messages are cut to this many characters */
+	static constexpr size_t MESSAGE_SIZE = 252;
+
+	/** Distinct lines written per second at most */
+	static constexpr unsigned int LINES_PER_SECOND = 100;
+
 	/**
 	 * @brief Get the singleton instance object
 	 * 
@@ -49,20 +78,43 @@ public:
 	void set_max_log_level(LOG_LEVEL level);
 
 	/**
-	 * @brief Destroy the Logger object
+	 * @brief Check if a message at level would be written
+	 * 
+	 * @param level level of the message
+	 * @return true If the message passes the max log level. Else, false.
+	 */
+	bool enabled(LOG_LEVEL level) const { return level != LOG_LEVEL::NONE && static_cast<int>(level) >= max_debug.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Block until every message logged so far is written, e.g. before printing to the same stream directly
+	 */
+	void flush(void) const;
+
+	/**
+	 * @brief Write to another stream from now on, stdout by default
+	 * 
+	 * @details Flushes first. The stream has to outlive the logger or the next set_output call.
+	 * 
+	 * @param out stream to write to
+	 */
+	void set_output(std::ostream &out);
+
+	/**
+	 * @brief Destroy the Logger object, writing whatever is still queued
 	 */
 	~Logger( void );
 	
 protected:
 private:
-	/** Hiding constructor to enforce singleton */
-	Logger(){}
-	
+	/** Hiding constructor to enforce singleton, starts the writer thread */
+	Logger();
+
 	/** Max debug level */
-	int max_debug = 0;
+	std::atomic<int> max_debug = 0;
 
-	/** Singleton object */
-	static Logger* m_logger;
+	/** Queue and writer thread */
+	struct Writer;
+	std::unique_ptr<Writer> m_writer;
 };
 
 /**
@@ -73,6 +125,28 @@ private:
  */
 void LOG(Logger::LOG_LEVEL level, std::string msg);
 
+/**
+ * @brief Lazily formatted logging
+ * 
+ * @details Levels below CHIP8_MIN_LOG_LEVEL compile to nothing. Otherwise the formatter
+ * 			is only called when the level passes the runtime max log level, so disabled
+ * 			messages never build a string.
+ * 
+ * @tparam level level to log at
+ * @tparam Formatter callable returning the message string
+ * @param format formatter called only when the message is written
+ */
+template <Logger::LOG_LEVEL level, typename Formatter>
+inline void LOG(Formatter&& format)
+{
+	if constexpr (level != Logger::LOG_LEVEL::NONE && static_cast<int>(level) >= CHIP8_MIN_LOG_LEVEL)
+	{
+		const Logger* logger = Logger::get_instance();
+		if (logger->enabled(level))
+			logger->log(level, std::forward<Formatter>(format)());
+	}
+}
+
 } // End of namespace util
 
 /*! @} End of Doxygen Groups*/
@@ -5,6 +5,9 @@
 #include <cstddef>          // Using for C++17 std::byte
 #include <unordered_map>    // Unordered map to represent memory space
 #include <memory>           // Memory for unique ptr
+#include <array>            // Contiguous memory space for FlatMemory
+#include <span>             // Block reads and writes
+#include <string>           // Exception messages
 
 /*!
  *  \addtogroup chip8
@@ -61,7 +64,7 @@ public:
     /**
      * @brief      Destroys the object.
      */
-    ~MemoryMap( void ) = default;
+    virtual ~MemoryMap( void ) = default;
 
 protected:
 
@@ -87,6 +90,15 @@ private:
      */
     void validate_adr_(const unsigned int& adr) const;
 
+    /**
+     * @brief      Build the start, requested and end address description used in exceptions
+     *
+     * @param[in]  adr   The requested address
+     *
+     * @return     Address description string
+     */
+    std::string adr_string_(const unsigned int& adr) const;
+
     /** Unordered map of std::bytes with unsigned int as key to represent memory map */
     std::unordered_map<unsigned int, std::byte> memory_space; 
 
@@ -97,6 +109,116 @@ private:
     int end_adr_; 
 };
 
+/**
+ * @brief      Contiguous memory map covering the whole 4 KB chip8 address space.
+ *
+ * @details    Every address is defined and zeroed on construction. The virtual store and read keep the
+ *             validated MemoryMap behaviour, while fetch, write and the block functions are the unchecked,
+ *             inlined fast path used by the interpreter. Fast path addresses wrap at 12 bits like the chip8 bus.
+ */
+class FlatMemory : public MemoryMap
+{
+
+public:
+
+    /** Size of the chip8 address space in bytes */
+    static constexpr unsigned int SIZE = 0x1000;
+
+    /** Mask applied to fast path addresses */
+    static constexpr unsigned int ADR_MASK = SIZE - 1;
+
+    /**
+     * @brief      Makes a zeroed flat memory map
+     *
+     * @return     Unique FlatMemory pointer
+     */
+    static std::unique_ptr<FlatMemory> makeFlatMemory( void );
+
+    /**
+     * @brief      Store a byte value. Every address already exists so update is ignored
+     *
+     * @param[in]  val     The value to store
+     * @param[in]  adr     The address to store the value at. Must be less than SIZE
+     * @param[in]  update  Unused
+     *
+     * @return     Always true, out of range addresses throw
+     */
+    bool store( const std::byte& val, const unsigned int& adr, const bool& update = false ) override;
+
+    /**
+     * @brief      Read a byte value
+     *
+     * @param[in]  adr   The address to read. Must be less than SIZE
+     *
+     * @return     Value of byte at address location
+     */
+    std::byte read( const unsigned int& adr ) const override;
+
+    /**
+     * @brief      Unchecked byte read
+     *
+     * @param[in]  adr   The address to read, wrapped to 12 bits
+     *
+     * @return     Value of byte at address location
+     */
+    std::byte fetch( const unsigned int& adr ) const noexcept { return memory_space_[adr & ADR_MASK]; }
+
+    /**
+     * @brief      Unchecked big endian opcode read of adr and adr + 1
+     *
+     * @param[in]  adr   The address of the opcode high byte, wrapped to 12 bits
+     *
+     * @return     16 bit opcode
+     */
+    unsigned int fetch_opcode( const unsigned int& adr ) const noexcept
+    {
+        return ((unsigned int)memory_space_[adr & ADR_MASK] << 8) | (unsigned int)memory_space_[(adr + 1) & ADR_MASK];
+    }
+
+    /**
+     * @brief      Unchecked byte write
+     *
+     * @param[in]  val   The value to write
+     * @param[in]  adr   The address to write, wrapped to 12 bits
+     */
+    void write( const std::byte& val, const unsigned int& adr ) noexcept { memory_space_[adr & ADR_MASK] = val; }
+
+    /**
+     * @brief      Copy out.size() bytes starting at adr. Wraps around the end of memory
+     *
+     * @param[in]  adr   The start address
+     * @param[out] out   Destination of the bytes
+     */
+    void read_block( const unsigned int& adr, std::span<std::byte> out ) const noexcept;
+
+    /**
+     * @brief      Copy in.size() bytes to memory starting at adr. Wraps around the end of memory
+     *
+     * @param[in]  adr   The start address
+     * @param[in]  in    Bytes to write
+     */
+    void write_block( const unsigned int& adr, std::span<const std::byte> in ) noexcept;
+
+    /**
+     * @brief      View of the whole address space
+     *
+     * @return     Span over all SIZE bytes
+     */
+    std::span<const std::byte, SIZE> data( void ) const noexcept { return memory_space_; }
+
+protected:
+
+    /**
+     * @brief      Constructs the object. Protected so user has to call factory method
+     */
+    FlatMemory( void );
+
+private:
+
+    /** Contiguous memory space */
+    alignas(64) std::array<std::byte, SIZE> memory_space_;
+};
+
 } // End of namespace chip8
 
 /*! @} End of Doxygen Groups*/
@@ -0,0 +1,105 @@
+#ifndef CHIP8_MOVIE_H
+#define CHIP8_MOVIE_H
+
+// Project includes
+#include "Interpreter.h"	// Interpreter to replay on
+
+// C++ includes
+#include <cstdint>	// Fixed width integers
+#include <string>	// File paths
+#include <vector>	// Per frame records
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Recorded input of a run: the seed, the quirks, and the key mask and resulting state hash of every frame
+ *
+ * @details Keys hold for a whole frame. Replaying on the same rom with the same seed, quirks and instructions
+ * 			per frame reproduces the run bit for bit, the hashes show the first frame where it did not.
+ */
+struct Movie
+{
+	/** Cxnn seed the run started from */
+	uint64_t seed = Interpreter::DEFAULT_SEED;
+
+	/** Instructions executed per frame */
+	uint32_t instructions_per_frame = 10;
+
+	/** Quirk set the run was recorded with */
+	uint8_t quirks = QUIRKS_NONE;
+
+	/** state_hash after reset, before the first frame. Catches a different rom or seed */
+	uint64_t start_hash = 0;
+
+	/** Key mask during each frame, bit k for key k */
+	std::vector<uint16_t> keys;
+
+	/** state_hash after each frame */
+	std::vector<uint64_t> hashes;
+};
+
+/**
+ * @brief Outcome of a replay
+ */
+struct ReplayResult
+{
+	/** Frames replayed with a matching hash */
+	uint64_t frames = 0;
+
+	/** Instructions executed */
+	uint64_t cycles = 0;
+
+	/** Host wall clock time of the replay in seconds */
+	double seconds = 0.0;
+
+	/** True if a hash did not match. frames is then where the run went apart, 0 for the start state */
+	bool desync = false;
+};
+
+/**
+ * @brief Hash of the complete interpreter state, memory included
+ *
+ * @param interpreter interpreter on flat memory
+ * @return uint64_t 64 bit hash, equal states hash equally
+ */
+uint64_t state_hash(const Interpreter &interpreter);
+
+/**
+ * @brief Replay a movie at full host speed, stopping at the first desync
+ *
+ * @param interpreter interpreter with the movie's rom loaded, it is seeded, set to the movie's quirks and reset first
+ * @param movie movie to replay
+ * @return ReplayResult frames replayed and whether the run desynced
+ */
+ReplayResult play_movie(Interpreter &interpreter, const Movie &movie);
+
+/**
+ * @brief Write a movie file: a fixed header, then the key masks, then the hashes
+ *
+ * @param path file to create or overwrite
+ * @param movie movie to write, keys and hashes of equal length
+ * @return true If the whole movie was written. Else, false.
+ */
+bool write_movie(const std::string &path, const Movie &movie);
+
+/**
+ * @brief Read a movie written by write_movie
+ *
+ * @param path file to read
+ * @param movie filled in on success
+ * @return true If the file is a whole movie of this version. Else, false.
+ */
+bool read_movie(const std::string &path, Movie &movie);
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_MOVIE_H
@@ -0,0 +1,118 @@
+#ifndef CHIP8_MPSC_QUEUE_H
+#define CHIP8_MPSC_QUEUE_H
+
+// C++ includes
+#include <array>	// Ring storage
+#include <atomic>	// Lock free indices
+#include <cstddef>	// Sizes
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Lock free multiple producer, single consumer ring queue with a fixed capacity
+ *
+ * @details Producers claim a slot by advancing the shared tail, every slot carries a sequence number
+ * 			that tells a producer whether the slot is free and the consumer whether it is filled.
+ * 			A full queue fails the push instead of making a producer wait.
+ *
+ * @tparam T element type, copyable
+ * @tparam CAPACITY number of elements, a power of two
+ */
+template <typename T, size_t CAPACITY>
+class MpscQueue
+{
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "Capacity has to be a power of two");
+
+  public:
+	/** Construct an empty queue, every slot free for the lap starting at it */
+	MpscQueue(void)
+	{
+		for (size_t i = 0; i < CAPACITY; ++i)
+			m_ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Append an element. Any thread
+	 *
+	 * @param value element to append
+	 * @return true If it was queued. Else, false when the queue is full.
+	 */
+	bool push(const T &value)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		Slot *slot;
+
+		for (;;)
+		{
+			slot = &m_ring[tail & (CAPACITY - 1)];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+			// Free for this lap, claim it. Else the consumer has not freed it yet, or another producer got it first
+			if (sequence == tail)
+			{
+				if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (sequence < tail)
+				return false;
+			else
+				tail = m_tail.load(std::memory_order_relaxed);
+		}
+
+		slot->value = value;
+		slot->sequence.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Oldest element without removing it. Consumer thread only
+	 *
+	 * @return const T* oldest element, null when the queue is empty or its producer is still writing it
+	 */
+	const T *front(void) const
+	{
+		const Slot &slot = m_ring[m_head & (CAPACITY - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+			return nullptr;
+
+		return &slot.value;
+	}
+
+	/**
+	 * @brief Remove the element returned by front, freeing its slot for the next lap. Consumer thread only
+	 */
+	void pop(void)
+	{
+		m_ring[m_head & (CAPACITY - 1)].sequence.store(m_head + CAPACITY, std::memory_order_release);
+		++m_head;
+	}
+
+  private:
+	/** Element and the lap it is free or filled for */
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::array<Slot, CAPACITY> m_ring;
+
+	/** Next slot to claim, shared by the producers */
+	alignas(64) std::atomic<size_t> m_tail{0};
+
+	/** Next element to read, only touched by the consumer */
+	alignas(64) size_t m_head = 0;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_MPSC_QUEUE_H
@@ -0,0 +1,91 @@
+#ifndef CHIP8_PARALLEL_RUNNER_H
+#define CHIP8_PARALLEL_RUNNER_H
+
+// Project includes
+#include "Headless.h"	// Headless runs, limits and stats
+#include "Movie.h"		// Movie replays
+#include "Rom.h"		// Rom images and load status
+
+// C++ includes
+#include <memory>	// Shared movies
+#include <string>	// Rom paths
+#include <vector>	// Jobs and results
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief One headless run: a rom, its scripted input and its cycle budget
+ */
+struct Job
+{
+	/** Path to the rom file */
+	std::string rom_path;
+
+	/** Key transitions sorted by frame */
+	std::vector<KeyEvent> script;
+
+	/** Cycle and frame budget */
+	RunLimits limits;
+
+	/** Replay this movie instead of the script and limits when set */
+	std::shared_ptr<const Movie> movie;
+};
+
+/**
+ * @brief Outcome of one job
+ */
+struct JobResult
+{
+	/** Why the rom could not be loaded, stats are empty then. OK once it ran */
+	RomStatus rom_status = RomStatus::NOT_FOUND;
+
+	/** Run statistics */
+	RunStats stats;
+
+	/** Outcome of the movie replay, for jobs with a movie */
+	ReplayResult replay;
+
+	/** Worker thread that ran the job */
+	unsigned int worker = 0;
+};
+
+/**
+ * @brief Options for the parallel runner
+ */
+struct ParallelOptions
+{
+	/** Worker threads. Zero uses every hardware thread */
+	unsigned int threads = 0;
+
+	/** Pin worker i to cpu i modulo the cpu count. Linux only, ignored elsewhere */
+	bool pin_threads = false;
+
+	/** Run jobs through the x86-64 recompiler where the host supports it */
+	bool jit = false;
+};
+
+/**
+ * @brief Run jobs on a work stealing pool of worker threads
+ * 
+ * @details Jobs are dealt round robin into one deque per worker. A worker pops from the back of
+ * 			its own deque and steals from the front of the others once it runs dry. Each worker reuses
+ * 			a single interpreter and memory map for all of its jobs, and every rom file is read once.
+ * 
+ * @param jobs jobs to run
+ * @param options thread count and affinity
+ * @return std::vector<JobResult> results in the same order as jobs
+ */
+std::vector<JobResult> run_parallel(const std::vector<Job> &jobs, const ParallelOptions &options = {});
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_PARALLEL_RUNNER_H
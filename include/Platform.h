@@ -0,0 +1,129 @@
+#ifndef CHIP8_PLATFORM_H
+#define CHIP8_PLATFORM_H
+
+// C++ includes
+#include <cstddef>	// Bytes
+#include <cstdint>	// Fixed width integers
+#include <span>		// Rom bytes
+#include <string>	// Quirk set names
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Machine a rom was written for
+ */
+enum class Platform : uint8_t
+{
+	/** COSMAC VIP CHIP-8, 64x32 */
+	CHIP8,
+
+	/** VIP two page CHIP-8, 64x64. Starts with a jump to 0x260 */
+	CHIP8_HIRES,
+
+	/** SUPER-CHIP 1.1, adds 128x64, scrolling and 16x16 sprites */
+	SCHIP,
+
+	/** XO-CHIP, adds long loads, register ranges, colour planes and audio */
+	XOCHIP
+};
+
+/**
+ * @brief Name of a platform for messages and listings
+ *
+ * @param platform platform to name
+ * @return const char* e.g. "SUPER-CHIP"
+ */
+const char *to_string(const Platform &platform);
+
+/**
+ * @brief Behaviours that CHIP-8 interpreters disagree on, as flags. A clear flag is what this interpreter does
+ */
+enum Quirk : uint8_t
+{
+	/** 8xy6 and 8xyE shift Vy into Vx, instead of shifting Vx in place */
+	QUIRK_SHIFT_VY = 1 << 0,
+
+	/** Fx55 and Fx65 leave I at I + x + 1 */
+	QUIRK_MEMORY_INCREMENT = 1 << 1,
+
+	/** Bxnn jumps to xnn + Vx, instead of Bnnn jumping to nnn + V0 */
+	QUIRK_JUMP_VX = 1 << 2,
+
+	/** Sprites are cut off at the screen edges instead of wrapping */
+	QUIRK_CLIP = 1 << 3,
+
+	/** 8xy1, 8xy2 and 8xy3 clear VF */
+	QUIRK_VF_RESET = 1 << 4
+};
+
+/**
+ * @brief Quirk sets the interpreter has a compiled loop for, one per platform
+ */
+enum QuirkSet : uint8_t
+{
+	/** This interpreter's own behaviour, which the CHIP-48 era roms of the corpus expect */
+	QUIRKS_NONE = 0,
+
+	/** COSMAC VIP */
+	QUIRKS_VIP = QUIRK_SHIFT_VY | QUIRK_MEMORY_INCREMENT | QUIRK_CLIP | QUIRK_VF_RESET,
+
+	/** SUPER-CHIP 1.1 */
+	QUIRKS_SCHIP = QUIRK_JUMP_VX | QUIRK_CLIP,
+
+	/** Octo's XO-CHIP */
+	QUIRKS_XOCHIP = QUIRK_SHIFT_VY | QUIRK_MEMORY_INCREMENT
+};
+
+/**
+ * @brief Quirk set by name, for command lines
+ *
+ * @param name none, vip, schip or xochip
+ * @param quirks set to the quirk set when the name is known, else left alone
+ * @return true If the name is known. Else, false.
+ */
+bool parse_quirks(const std::string &name, uint8_t &quirks);
+
+/**
+ * @brief How to run roms of a platform
+ */
+struct PlatformProfile
+{
+	/** Quirk flags the platform's roms expect */
+	uint8_t quirks;
+
+	/** Instructions per 60 Hz frame the roms were timed for */
+	uint16_t instructions_per_frame;
+};
+
+/**
+ * @brief Quirks and speed for a platform
+ *
+ * @param platform platform to look up
+ * @return PlatformProfile recommended settings
+ */
+PlatformProfile platform_profile(const Platform &platform);
+
+/**
+ * @brief Guess the platform of a rom from the instructions it can reach
+ *
+ * @details Follows jumps, calls and skips from the program start, so sprites and other data are never read as
+ * 			opcodes. Paths end at returns, computed jumps and words that are no instruction. The newest
+ * 			platform with an instruction on a reached path wins.
+ *
+ * @param rom rom bytes, loaded at the program start
+ * @return Platform detected platform, CHIP8 when nothing newer is used
+ */
+Platform detect_platform(std::span<const std::byte> rom);
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_PLATFORM_H
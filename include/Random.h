@@ -0,0 +1,86 @@
+#ifndef CHIP8_RANDOM_H
+#define CHIP8_RANDOM_H
+
+// C++ includes
+#include <bit>		// Rotate
+#include <cstdint>	// Fixed width integers
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief PCG32 random number generator, XSH RR output over a 64 bit LCG
+ *
+ * @details The whole state is one word, so it is cheap to seed, copy and save. Uses a fixed stream.
+ */
+class Pcg32
+{
+
+  public:
+	/**
+	 * @brief Construct a generator
+	 *
+	 * @param seed any value, equal seeds give equal sequences
+	 */
+	explicit Pcg32(const uint64_t &seed = 0) { this->seed(seed); }
+
+	/**
+	 * @brief Restart the sequence for a seed
+	 *
+	 * @param seed any value, equal seeds give equal sequences
+	 */
+	void seed(const uint64_t &seed)
+	{
+		m_state = 0;
+		(*this)();
+		m_state += seed;
+		(*this)();
+	}
+
+	/**
+	 * @brief Next number in the sequence
+	 *
+	 * @return uint32_t uniformly distributed value
+	 */
+	uint32_t operator()(void)
+	{
+		const uint64_t old = m_state;
+		m_state = old * MULTIPLIER + INCREMENT;
+
+		const uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+		return std::rotr(xorshifted, (int)(old >> 59));
+	}
+
+	/**
+	 * @brief Generator state, for saving
+	 *
+	 * @return uint64_t state word
+	 */
+	uint64_t state(void) const { return m_state; }
+
+	/**
+	 * @brief Continue from a saved state
+	 *
+	 * @param state word returned by state
+	 */
+	void set_state(const uint64_t &state) { m_state = state; }
+
+  private:
+	/** LCG constants from the PCG reference implementation */
+	static constexpr uint64_t MULTIPLIER = 6364136223846793005ull, INCREMENT = 1442695040888963407ull;
+
+	/** LCG state */
+	uint64_t m_state;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_RANDOM_H
@@ -0,0 +1,116 @@
+#ifndef CHIP8_RECOMPILER_H
+#define CHIP8_RECOMPILER_H
+
+// Project includes
+#include "Interpreter.h"	// Guest state and fallback handlers
+
+// C++ includes
+#include <array>	// Block tables
+#include <bitset>	// Translated address ranges
+#include <cstdint>	// Fixed width integers
+#include <memory>	// Memory for unique ptr
+#include <vector>	// Pending chain patches
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Dynamic recompiler translating guest basic blocks into x86-64 code
+ *
+ * @details Guest state stays pinned in the owning Interpreter, generated code addresses it through rbx.
+ * 			Arithmetic, loads of I, jumps and skips are translated, every other opcode calls its
+ * 			Interpreter handler and ends the block. Blocks with a known successor jump straight into it
+ * 			once it is translated. A store into any translated address drops every block.
+ * 			Only available on x86-64 hosts with mmap, make_recompiler returns null elsewhere.
+ */
+class Recompiler
+{
+
+  public:
+	/**
+	 * @brief Factory method for recompiler
+	 *
+	 * @param cpu interpreter whose state the generated code works on, must use flat memory
+	 * @return std::unique_ptr<Recompiler> resulting recompiler, null if the host or memory is unsupported
+	 */
+	static std::unique_ptr<Recompiler> make_recompiler(Interpreter &cpu);
+
+	/** Releases the executable memory */
+	~Recompiler(void);
+
+	/**
+	 * @brief Execute like Interpreter::run_cycles and Interpreter::run_until_frame
+	 *
+	 * @param cycles maximum number of instructions to execute
+	 * @param stop_on_draw return once a draw instruction sets the draw flag
+	 * @return Interpreter::RunResult why it stopped
+	 */
+	Interpreter::RunResult run(uint64_t cycles, const bool &stop_on_draw);
+
+	/**
+	 * @brief Drop every block if a store to [adr, adr + size) touched translated code
+	 */
+	void invalidate(const unsigned int &adr, const size_t &size);
+
+	/**
+	 * @brief Drop every block
+	 */
+	void flush(void);
+
+	/**
+	 * @brief Number of blocks translated since construction
+	 *
+	 * @return uint64_t Translated block count
+	 */
+	uint64_t translated(void) const { return m_translated; }
+
+  private:
+	/** Private constructor to enforce unique pointer factory method */
+	Recompiler(Interpreter &cpu, uint8_t *code, const size_t &size);
+
+	/** Translate the block starting at pc, return its entry or null if the code buffer is full */
+	const uint8_t *compile(const unsigned int &pc);
+
+	/** Interpreter the generated code runs on */
+	Interpreter &m_cpu;
+
+	/** Executable buffer, entry and exit thunks first, blocks after */
+	uint8_t *m_code;
+	size_t m_code_size;
+
+	/** Write cursor into m_code, and where blocks start after a flush */
+	size_t m_code_used, m_code_start;
+
+	/** Thunk from C++ into a block, and the shared exit back out of generated code */
+	const uint8_t *m_enter, *m_exit;
+
+	/** Entry of the block starting at every address, read by generated code through r13 */
+	std::array<const uint8_t *, FlatMemory::SIZE> m_entry;
+
+	/** Set while run_until_frame is running, read by generated code */
+	uint8_t m_stop_on_draw;
+
+	/** Instructions in the block starting at every address */
+	std::array<uint8_t, FlatMemory::SIZE> m_length;
+
+	/** Addresses read by any translated block */
+	std::bitset<FlatMemory::SIZE> m_covered;
+
+	/** Offsets of jumps waiting for a block to be translated at every address */
+	std::array<std::vector<uint32_t>, FlatMemory::SIZE> m_links;
+
+	/** Blocks translated since construction */
+	uint64_t m_translated;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_RECOMPILER_H
@@ -0,0 +1,113 @@
+#ifndef CHIP8_REWIND_H
+#define CHIP8_REWIND_H
+
+// Project includes
+#include "SaveState.h"	// Snapshots
+
+// C++ includes
+#include <cstddef>	// Sizes
+#include <cstdint>	// Fixed width integers
+#include <deque>	// Keyframe groups
+#include <vector>	// Encoded bytes
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief History of save states, one per frame, for stepping backward through play
+ *
+ * @details States are kept in groups that start with a keyframe. Every other state is stored as the run
+ * 			length encoded XOR against its group's keyframe, so any state decodes in one pass and an
+ * 			unchanged frame costs a few bytes. Keyframes are encoded the same way against zero.
+ * 			The oldest group is dropped once the rest still holds the requested history.
+ */
+class RewindBuffer
+{
+
+  public:
+	/**
+	 * @brief Construct an empty history
+	 *
+	 * @param capacity states to keep at least, e.g. seconds times FrameScheduler::FRAME_RATE
+	 * @param keyframe_interval states per group, larger groups compress better and drop history in bigger steps
+	 */
+	explicit RewindBuffer(const size_t &capacity, const size_t &keyframe_interval = 60);
+
+	/**
+	 * @brief Append the newest state
+	 *
+	 * @param state state to remember
+	 */
+	void push(const SaveState &state);
+
+	/**
+	 * @brief Remove the newest state
+	 *
+	 * @param state filled with the removed state
+	 * @return true If there was one. Else, false when the history is empty.
+	 */
+	bool pop(SaveState &state);
+
+	/**
+	 * @brief Drop all history
+	 */
+	void clear(void);
+
+	/**
+	 * @brief States held
+	 *
+	 * @return size_t number of states pop can return
+	 */
+	size_t size(void) const { return m_size; }
+
+	/**
+	 * @brief Encoded size of the history
+	 *
+	 * @return size_t bytes of encoded states, excluding the decoded keyframe kept for encoding
+	 */
+	size_t bytes(void) const { return m_bytes; }
+
+  private:
+	/** Keyframe and the states after it, each encoded record ends at the matching entry of ends */
+	struct Group
+	{
+		std::vector<uint8_t> data;
+		std::vector<uint32_t> ends;
+	};
+
+	/** Append the XOR of state against base, as runs of equal bytes and literal XOR bytes */
+	static void encode(const uint8_t *state, const uint8_t *base, std::vector<uint8_t> &out);
+
+	/** Rebuild a state from base and a record written by encode */
+	static void decode(const uint8_t *record, const uint8_t *base, uint8_t *state);
+
+	/** Decode the newest group's keyframe into m_keyframe */
+	void load_keyframe(void);
+
+	/** Requested history and states per group */
+	size_t m_capacity, m_keyframe_interval;
+
+	/** States held and their encoded bytes */
+	size_t m_size, m_bytes;
+
+	/** Oldest group first */
+	std::deque<Group> m_groups;
+
+	/** Groups dropped from the front, kept to reuse their storage */
+	std::vector<Group> m_spare;
+
+	/** Keyframe of the newest group, decoded */
+	SaveState m_keyframe;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_REWIND_H
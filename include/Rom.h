@@ -0,0 +1,166 @@
+#ifndef CHIP8_ROM_H
+#define CHIP8_ROM_H
+
+// Project includes
+#include "Memory.h"	// For memory map
+#include "Platform.h"	// Platform of the rom
+
+// C++ includes
+#include <array>	// Font set
+#include <cstdint>	// Fixed width integers
+#include <memory>			// Memory for unique ptr
+#include <mutex>			// Cache lock
+#include <span>				// Rom bytes
+#include <string>			// Rom file path
+#include <unordered_map>	// Cached images by hash
+#include <vector>			// Rom bytes
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/** Chip8 fontset loaded into each rom at the start */
+extern const std::array<uint8_t, 80> FONTSET;
+
+/** SUPER-CHIP big digits loaded after it, for Fx30 */
+extern const std::array<uint8_t, 160> BIG_FONTSET;
+
+/**
+ * @brief Why a rom did or did not load
+ */
+enum class RomStatus { OK, NOT_FOUND, UNREADABLE, EMPTY, TOO_LARGE };
+
+/**
+ * @brief Name of a status for messages
+ * 
+ * @param status status to name
+ * @return const char* short description, e.g. "file not found"
+ */
+const char *to_string(const RomStatus &status);
+
+/**
+ * @brief Power on memory of a rom: the font sets, zeros and the rom at the program start
+ * 
+ * @details Immutable once built, so one image is shared by every load of the same rom.
+ */
+struct RomImage
+{
+	/** rom_hash of the rom bytes */
+	uint64_t hash;
+
+	/** Rom bytes at the program start */
+	size_t size;
+
+	/** detect_platform of the rom bytes, pick the interpreter's quirks from it */
+	Platform platform;
+
+	/** Whole memory, copied in one block by load_image */
+	std::array<std::byte, FlatMemory::SIZE> memory;
+
+	/**
+	 * @brief Rom bytes within the image
+	 * 
+	 * @return std::span<const std::byte> size bytes from the program start
+	 */
+	std::span<const std::byte> rom(void) const;
+};
+
+/**
+ * @brief Content hash of rom bytes, equal roms hash equally whatever their file is called
+ * 
+ * @param rom rom bytes
+ * @return uint64_t 64 bit FNV-1a hash over 64 bit words
+ */
+uint64_t rom_hash(std::span<const std::byte> rom);
+
+/**
+ * @brief Build the power on image of rom bytes
+ * 
+ * @param rom rom bytes, at most FlatMemory::SIZE - PROG_START of them
+ * @return std::shared_ptr<const RomImage> new image
+ */
+std::shared_ptr<const RomImage> make_rom_image(std::span<const std::byte> rom);
+
+/**
+ * @brief Read a whole rom file with a single read
+ * 
+ * @param rom_file_path path to the rom file
+ * @param rom bytes of the rom, left empty unless the status is OK
+ * @return RomStatus OK, or why the file can not be a rom
+ */
+RomStatus read_rom_file(const std::string &rom_file_path, std::vector<std::byte> &rom);
+
+/**
+ * @brief Reset flat memory to the power on image: font sets, zeros and the rom at the program start
+ * 
+ * @param memory memory to overwrite
+ * @param rom rom bytes
+ */
+void load_image(FlatMemory &memory, std::span<const std::byte> rom);
+
+/**
+ * @brief Reset flat memory to a prebuilt power on image with a single block copy
+ * 
+ * @param memory memory to overwrite
+ * @param image image from make_rom_image or a RomCache
+ */
+void load_image(FlatMemory &memory, const RomImage &image);
+
+/**
+ * @brief Load a rom file into a new flat memory map along with the font sets
+ * 
+ * @param rom_file_path path to the rom file
+ * @param memory set to the memory map holding the font and rom when the status is OK, else left alone
+ * @return RomStatus OK, or why the rom did not load
+ */
+RomStatus load_rom(const std::string &rom_file_path, std::unique_ptr<FlatMemory> &memory);
+
+/**
+ * @brief Power on images of every rom loaded through it, keyed by content hash
+ * 
+ * @details Thread safe. A file is read and hashed on every load, its image is only built the first time
+ * 			its content is seen, so copies of a rom under different names share one image.
+ */
+class RomCache
+{
+
+  public:
+	/**
+	 * @brief Image of a rom file, built unless the cache already holds one with the same content
+	 * 
+	 * @param rom_file_path path to the rom file
+	 * @param image set to the shared image when the status is OK, else left alone
+	 * @return RomStatus OK, or why the rom did not load
+	 */
+	RomStatus load(const std::string &rom_file_path, std::shared_ptr<const RomImage> &image);
+
+	/**
+	 * @brief Distinct images held
+	 * 
+	 * @return size_t number of images
+	 */
+	size_t size(void) const;
+
+	/**
+	 * @brief Drop the cache's references, images still in use stay alive with their users
+	 */
+	void clear(void);
+
+  private:
+	/** Guards m_images */
+	mutable std::mutex m_mutex;
+
+	/** Images by rom_hash */
+	std::unordered_map<uint64_t, std::shared_ptr<const RomImage>> m_images;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_ROM_H
@@ -0,0 +1,94 @@
+#ifndef CHIP8_SAVE_STATE_H
+#define CHIP8_SAVE_STATE_H
+
+// C++ includes
+#include <array>		// Fixed size fields
+#include <cstddef>		// Bytes
+#include <cstdint>		// Fixed width integers
+#include <string>		// File paths
+#include <type_traits>	// Layout checks
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Complete interpreter state in one fixed layout block
+ *
+ * @details Files hold exactly this struct in host byte order, so saving is one copy and loading
+ * 			is one read or an mmap with no per field parsing. Any layout change bumps VERSION.
+ */
+struct SaveState
+{
+	/** "C8SS" read as a little endian word */
+	static constexpr uint32_t MAGIC = 0x53533843;
+
+	/** Layout version */
+	static constexpr uint32_t VERSION = 2;
+
+	/** Bits of flags */
+	static constexpr uint8_t EXIT = 0x1, DRAW = 0x2, KEY_WAIT = 0x4;
+
+	uint32_t magic;
+	uint32_t version;
+
+	/** Instructions executed since reset */
+	uint64_t cycles;
+
+	/** Cxnn seed and the generator word */
+	uint64_t seed, random;
+
+	/** Program counter, index register, stack pointer and key mask */
+	uint16_t pc, index, sp, keys;
+
+	/** Timers and EXIT, DRAW, KEY_WAIT */
+	uint8_t delay, sound, flags;
+
+	/** Quirk set and screen size in pixels */
+	uint8_t quirks, width, height;
+	uint8_t reserved[2];
+
+	std::array<uint16_t, 16> stack;
+	std::array<uint8_t, 16> registers;
+
+	/** SUPER-CHIP RPL user flags */
+	std::array<uint8_t, 16> rpl;
+
+	/** Screen rows of two words, most significant bit of the first at x = 0 */
+	std::array<std::array<uint64_t, 2>, 64> rows;
+
+	/** Whole flat memory */
+	std::array<std::byte, 0x1000> memory;
+};
+
+static_assert(std::is_trivially_copyable_v<SaveState> && std::is_standard_layout_v<SaveState>, "Save states are copied as raw bytes");
+static_assert(sizeof(SaveState) == 5232, "Save state layout changed, bump SaveState::VERSION");
+
+/**
+ * @brief Write a save state to a file
+ *
+ * @param path file to create or overwrite
+ * @param state state to write
+ * @return true If the whole state was written. Else, false.
+ */
+bool write_state(const std::string &path, const SaveState &state);
+
+/**
+ * @brief Read a save state written by write_state
+ *
+ * @param path file to read
+ * @param state filled in on success
+ * @return true If the file has the size, magic and version of a save state. Else, false.
+ */
+bool read_state(const std::string &path, SaveState &state);
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_SAVE_STATE_H
@@ -0,0 +1,180 @@
+#ifndef CHIP8_SCHEDULER_H
+#define CHIP8_SCHEDULER_H
+
+// Project includes
+#include "Interpreter.h"	// Interpreter to run
+#include "SpscQueue.h"		// Input from another thread
+
+// C++ includes
+#include <chrono>	// Frame deadlines
+#include <cstdint>	// Fixed width integers
+#include <span>		// Inputs of one frame
+#include <vector>	// Drained inputs
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Options for the frame scheduler
+ */
+struct SchedulerOptions
+{
+	/** Instructions executed per 60 Hz frame */
+	unsigned int instructions_per_frame = 10;
+
+	/** Run frames back to back with no pacing, so wall clock time has no influence on a run */
+	bool deterministic = false;
+};
+
+/**
+ * @brief Key transition applied when the frame reaches a guest cycle
+ */
+struct KeyInput
+{
+	/** Instructions into the frame */
+	uint32_t cycle;
+
+	/** Chip8 key 0x0 to 0xF */
+	uint8_t key;
+
+	/** True for key down, false for key up */
+	bool pressed;
+};
+
+/**
+ * @brief Key transition stamped with the host time it happened at
+ */
+struct KeyTransition
+{
+	/** When the host saw the transition */
+	std::chrono::steady_clock::time_point time;
+
+	/** Chip8 key 0x0 to 0xF */
+	uint8_t key;
+
+	/** True for key down, false for key up */
+	bool pressed;
+};
+
+/** Transitions from the thread pumping host events to the emulation thread */
+typedef SpscQueue<KeyTransition, 256> InputQueue;
+
+/**
+ * @brief Runs an interpreter in 60 Hz frames of virtual time
+ *
+ * @details Every frame executes a fixed instruction budget and then ticks the timers exactly once.
+ * 			Paced runs wait for absolute deadlines, sleeping with clock_nanosleep where available
+ * 			and spinning for the last stretch so host sleep jitter never reaches the guest.
+ */
+class FrameScheduler
+{
+
+  public:
+	/** Frames per second of virtual time */
+	static constexpr unsigned int FRAME_RATE = 60;
+
+	/**
+	 * @brief Construct a scheduler, the first frame is due immediately
+	 *
+	 * @param interpreter interpreter to run
+	 * @param options instruction rate and pacing
+	 */
+	FrameScheduler(Interpreter &interpreter, const SchedulerOptions &options);
+
+	/**
+	 * @brief Wait for the next frame deadline unless deterministic, then run one frame
+	 *
+	 * @details A key wait or the exit flag ends the frame's instructions early, the timers still tick.
+	 *
+	 * @return Interpreter::RunResult CYCLES once the whole budget ran, else why the frame ended early
+	 */
+	Interpreter::RunResult run_frame(void);
+
+	/**
+	 * @brief Same as run_frame with a smaller instruction budget, for runs capped at a cycle count
+	 *
+	 * @param budget instructions to execute this frame
+	 * @return Interpreter::RunResult CYCLES once the whole budget ran, else why the frame ended early
+	 */
+	Interpreter::RunResult run_frame(const uint64_t &budget);
+
+	/**
+	 * @brief Same as run_frame with a budget, applying key transitions as the frame reaches their cycles
+	 *
+	 * @details A key wait idles until the next transition instead of spinning on Fx0A.
+	 *
+	 * @param budget instructions to execute this frame
+	 * @param inputs transitions sorted by cycle, cycles past the budget apply at the end of the frame
+	 * @return Interpreter::RunResult CYCLES once the whole budget ran, else why the frame ended early
+	 */
+	Interpreter::RunResult run_frame(const uint64_t &budget, std::span<const KeyInput> inputs);
+
+	/**
+	 * @brief Run one frame with the transitions the host saw during the previous one
+	 *
+	 * @details Each transition lands at the cycle matching where it happened within the previous frame's
+	 * 			wall clock time, one frame late. Deterministic runs apply everything queued at cycle 0.
+	 *
+	 * @param queue transitions from the event pump, newer ones are left for the next frame
+	 * @return Interpreter::RunResult CYCLES once the whole budget ran, else why the frame ended early
+	 */
+	Interpreter::RunResult run_frame(InputQueue &queue);
+
+	/**
+	 * @brief Wait for the next frame deadline unless deterministic, without running the interpreter
+	 *
+	 * @details For frames the interpreter sits out, e.g. while rewinding. They do not count as frames run.
+	 */
+	void skip_frame(void);
+
+	/**
+	 * @brief Frames run so far
+	 *
+	 * @return uint64_t Frame counter
+	 */
+	uint64_t frames(void) const { return m_frames; }
+
+	/**
+	 * @brief Deadlines missed by more than a frame, the schedule restarts from now after each one
+	 *
+	 * @return uint64_t Late frame counter
+	 */
+	uint64_t late_frames(void) const { return m_late_frames; }
+
+  private:
+	/** Sleep, then spin, until the next deadline */
+	void wait(void);
+
+	/** Run the instructions of a frame between key transitions, then tick the timers */
+	Interpreter::RunResult execute(const uint64_t &budget, std::span<const KeyInput> inputs);
+
+	/** Interpreter being scheduled */
+	Interpreter &m_interpreter;
+
+	/** Instruction rate and pacing */
+	SchedulerOptions m_options;
+
+	/** Frames run and frames that started too late */
+	uint64_t m_frames, m_late_frames;
+
+	/** Deadline of the next frame */
+	std::chrono::steady_clock::time_point m_deadline;
+
+	/** Wall clock start of the current and the previous frame */
+	std::chrono::steady_clock::time_point m_frame_start, m_previous_start;
+
+	/** Transitions drained for the current frame, kept to reuse its storage */
+	std::vector<KeyInput> m_inputs;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_SCHEDULER_H
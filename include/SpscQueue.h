@@ -0,0 +1,82 @@
+#ifndef CHIP8_SPSC_QUEUE_H
+#define CHIP8_SPSC_QUEUE_H
+
+// C++ includes
+#include <array>	// Ring storage
+#include <atomic>	// Lock free indices
+#include <cstddef>	// Sizes
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Lock free single producer, single consumer ring queue with a fixed capacity
+ *
+ * @details Head and tail only ever grow and are masked into the ring, each is written by one thread.
+ *
+ * @tparam T element type, copyable
+ * @tparam CAPACITY number of elements, a power of two
+ */
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+	static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "Capacity has to be a power of two");
+
+  public:
+	/**
+	 * @brief Append an element. Producer thread only
+	 *
+	 * @param value element to append
+	 * @return true If it was queued. Else, false when the queue is full.
+	 */
+	bool push(const T &value)
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) == CAPACITY)
+			return false;
+
+		m_ring[tail & (CAPACITY - 1)] = value;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Oldest element without removing it. Consumer thread only
+	 *
+	 * @return const T* oldest element, null when the queue is empty
+	 */
+	const T *front(void) const
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return nullptr;
+
+		return &m_ring[head & (CAPACITY - 1)];
+	}
+
+	/**
+	 * @brief Remove the element returned by front. Consumer thread only
+	 */
+	void pop(void) { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  private:
+	std::array<T, CAPACITY> m_ring;
+
+	/** Next element to read, written by the consumer */
+	alignas(64) std::atomic<size_t> m_head{0};
+
+	/** Next slot to write, written by the producer */
+	alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_SPSC_QUEUE_H
@@ -0,0 +1,189 @@
+#ifndef CHIP8_TRACE_H
+#define CHIP8_TRACE_H
+
+// C++ includes
+#include <cstddef>	// Sizes
+#include <cstdint>	// Fixed width integers
+#include <memory>	// Factory methods
+#include <string>	// File paths
+#include <vector>	// Decoded records
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief One executed instruction, as written to the trace ring
+ */
+struct TraceRecord
+{
+	/** Instructions executed before this one */
+	uint64_t cycle;
+
+	/** Address the instruction was fetched from */
+	uint16_t pc;
+
+	/** Instruction executed */
+	uint16_t opcode;
+
+	/** Index register after the instruction */
+	uint16_t index;
+
+	/** Register named by the opcode's x nibble, and its value after the instruction. Changed when the opcode writes Vx */
+	uint8_t x, vx;
+};
+
+/**
+ * @brief Start of a trace file, followed by capacity records
+ */
+struct TraceHeader
+{
+	/** Tells trace files apart from anything else */
+	static constexpr char MAGIC[4] = {'C', '8', 'T', 'R'};
+
+	/** Bumped whenever the layout changes */
+	static constexpr uint32_t VERSION = 1;
+
+	char magic[4];
+	uint32_t version;
+
+	/** Records the ring holds, a power of two */
+	uint32_t capacity;
+
+	/** One instruction in sample is recorded */
+	uint32_t sample;
+
+	/** Records written since the ring was created, the newest is at (written - 1) % capacity */
+	uint64_t written;
+
+	uint8_t reserved[40];
+};
+
+static_assert(sizeof(TraceRecord) == 16, "Trace records are a fixed 16 bytes");
+static_assert(sizeof(TraceHeader) == 64, "Trace headers are a fixed 64 bytes");
+
+/**
+ * @brief Fixed size ring of the last executed instructions
+ *
+ * @details Recording is a countdown for sampling, a 16 byte store and a counter update, so it can stay on.
+ * 			A ring mapped to a file is written straight into the page cache and survives the process crashing.
+ */
+class TraceRing
+{
+
+  public:
+	/**
+	 * @brief Factory method for a ring in memory
+	 *
+	 * @param capacity records to keep, rounded up to a power of two
+	 * @param sample record one instruction in sample, 1 records all of them
+	 * @return std::unique_ptr<TraceRing> resulting ring
+	 */
+	static std::unique_ptr<TraceRing> make_trace_ring(const uint32_t &capacity, const uint32_t &sample = 1);
+
+	/**
+	 * @brief Factory method for a ring mapped to a file, replacing whatever the file held
+	 *
+	 * @param path trace file to create
+	 * @param capacity records to keep, rounded up to a power of two
+	 * @param sample record one instruction in sample, 1 records all of them
+	 * @return std::unique_ptr<TraceRing> resulting ring, null when the file can not be created or mapped
+	 */
+	static std::unique_ptr<TraceRing> map_trace_file(const std::string &path, const uint32_t &capacity, const uint32_t &sample = 1);
+
+	/** Destructor, unmaps a file backed ring */
+	~TraceRing(void);
+
+	TraceRing(const TraceRing &) = delete;
+	TraceRing &operator=(const TraceRing &) = delete;
+
+	/**
+	 * @brief Record an instruction, unless sampling skips it
+	 *
+	 * @param record executed instruction
+	 */
+	void record(const TraceRecord &record)
+	{
+		if (--m_countdown != 0)
+			return;
+		m_countdown = m_sample;
+
+		m_records[m_written & m_mask] = record;
+		m_header->written = ++m_written;
+	}
+
+	/**
+	 * @brief Records written since creation, including the ones the ring has overwritten
+	 *
+	 * @return uint64_t record counter
+	 */
+	uint64_t written(void) const { return m_header->written; }
+
+	/**
+	 * @brief Records the ring can hold
+	 *
+	 * @return uint32_t capacity
+	 */
+	uint32_t capacity(void) const { return m_header->capacity; }
+
+	/**
+	 * @brief Records still held, oldest first
+	 *
+	 * @return std::vector<TraceRecord> up to capacity records
+	 */
+	std::vector<TraceRecord> records(void) const;
+
+  private:
+	/** Private constructor to enforce unique pointer factory methods */
+	TraceRing(void);
+
+	/** Fill in the header of freshly allocated storage */
+	void init(const uint32_t &capacity, const uint32_t &sample);
+
+	/** Header followed by the records, on the heap or mapped */
+	TraceHeader *m_header;
+	TraceRecord *m_records;
+
+	/** Heap storage when not mapped */
+	std::unique_ptr<uint8_t[]> m_storage;
+
+	/** Mapping to release, zero bytes when on the heap */
+	void *m_mapping;
+	size_t m_mapped_bytes;
+
+	/** Header fields kept next to the ring pointer, the header only gets the counter stored back */
+	uint64_t m_written;
+	uint32_t m_mask, m_sample;
+
+	/** Instructions left until the next recorded one */
+	uint32_t m_countdown;
+};
+
+/**
+ * @brief Read the records a trace file still holds, e.g. after the process that wrote it crashed
+ *
+ * @param path trace file
+ * @param header filled with the file's header
+ * @param records filled with the records, oldest first
+ * @return true If the file is a complete trace. Else, false.
+ */
+bool read_trace(const std::string &path, TraceHeader &header, std::vector<TraceRecord> &records);
+
+/**
+ * @brief Whether an opcode stores to the register named by its x nibble
+ *
+ * @param opcode 16 bit opcode
+ * @return true If TraceRecord::vx holds a new value of Vx. Else, false.
+ */
+bool writes_vx(const uint16_t &opcode);
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_TRACE_H
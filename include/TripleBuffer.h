@@ -0,0 +1,92 @@
+#ifndef CHIP8_TRIPLE_BUFFER_H
+#define CHIP8_TRIPLE_BUFFER_H
+
+// C++ includes
+#include <array>	// Slots
+#include <atomic>	// Lock free slot exchange
+#include <cstdint>	// Fixed width integers
+
+/*!
+ *  \addtogroup chip8
+ *  @{
+ */
+
+//! chip8 code
+namespace chip8
+{
+
+/**
+ * @brief Lock free single producer, single consumer triple buffer
+ *
+ * @details The writer fills the back slot and publishes it by swapping it with the middle slot.
+ * 			The reader swaps the middle slot into the front whenever a newer one was published.
+ * 			Neither side ever waits for the other, the writer may lap a slow reader and the reader
+ * 			always gets the latest complete value.
+ *
+ * @tparam T slot type, default constructible and copyable
+ */
+template <typename T>
+class TripleBuffer
+{
+
+  public:
+	/**
+	 * @brief Slot the writer fills next. Writer thread only
+	 *
+	 * @return T& back slot
+	 */
+	T &back(void) { return m_slots[m_back].value; }
+
+	/**
+	 * @brief Make the back slot the latest value and take the previous middle slot as the new back. Writer thread only
+	 */
+	void publish(void) { m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+	/**
+	 * @brief Take the latest published value into the front slot if there is a newer one. Reader thread only
+	 *
+	 * @return true If front changed. Else, false.
+	 */
+	bool update(void)
+	{
+		if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+			return false;
+
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+
+	/**
+	 * @brief Latest value taken by update. Reader thread only
+	 *
+	 * @return const T& front slot
+	 */
+	const T &front(void) const { return m_slots[m_front].value; }
+
+  private:
+	/** Middle index bits, and the flag set while the middle slot has not been read */
+	static constexpr uint8_t INDEX = 0x3, FRESH = 0x4;
+
+	/** Slots on their own cache lines so the two threads never share one */
+	struct alignas(64) Slot
+	{
+		T value{};
+	};
+
+	std::array<Slot, 3> m_slots;
+
+	/** Shared middle slot index plus FRESH */
+	alignas(64) std::atomic<uint8_t> m_middle{1};
+
+	/** Writer's back slot index */
+	alignas(64) uint8_t m_back = 0;
+
+	/** Reader's front slot index */
+	alignas(64) uint8_t m_front = 2;
+};
+
+} // namespace chip8
+
+/*! @} End of Doxygen Groups*/
+
+#endif // CHIP8_TRIPLE_BUFFER_H
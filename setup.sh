@@ -4,6 +4,7 @@ sudo apt-get update
 sudo apt-get install -y cmake
 sudo apt-get install -y libsdl2-dev
 sudo apt-get install -y lslibgtest-dev
+sudo apt-get install -y libbenchmark-dev
 
 mkdir build
 cd build
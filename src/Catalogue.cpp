@@ -0,0 +1,406 @@
+// Project includes
+#include "../include/Catalogue.h"	// Class definition
+#include "../include/Logger.h"		// Logger functionality
+#include "../include/Rom.h"			// Reading and hashing roms
+
+// C++ includes
+#include <algorithm>		// Sorting
+#include <cctype>			// Field names
+#include <chrono>			// Modification times
+#include <cstring>			// memcmp
+#include <filesystem>		// Walking the corpus
+#include <fstream>			// Sidecars and index files
+#include <unordered_map>	// Groups by hash
+
+#if defined(__unix__)
+#include <fcntl.h>		// open
+#include <sys/mman.h>	// mmap
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// close
+#endif
+
+namespace	/* Module functions */
+{
+// Modification time in the unit the index stores
+int64_t modified_ns( const std::filesystem::file_time_type& time )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Text without leading and trailing blanks
+std::string trim( const std::string& text )
+{
+	const size_t first = text.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+		return "";
+	return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// Four digits, or a decade like 199x
+bool is_year( const std::string& text )
+{
+	return text.size() == 4 && std::all_of(text.begin(), text.end(), [](const char& c) { return std::isdigit((unsigned char)c) || c == 'x'; });
+}
+
+// Corpus names follow "Title [Author, Year] (variant).ch8"
+void parse_file_name( const std::filesystem::path& path, chip8::CatalogueRecord& record )
+{
+	const std::string stem = path.extension() == ".ch8" ? path.stem().string() : path.filename().string();
+
+	const size_t open = stem.find(" [");
+	const size_t close = open == std::string::npos ? std::string::npos : stem.find(']', open);
+	if (close == std::string::npos)
+	{
+		record.title = stem;
+		return;
+	}
+
+	record.title = stem.substr(0, open);
+	const std::string credit = stem.substr(open + 2, close - open - 2);
+	const size_t comma = credit.rfind(", ");
+
+	if (comma != std::string::npos && is_year(credit.substr(comma + 2)))
+	{
+		record.author = credit.substr(0, comma);
+		record.date = credit.substr(comma + 2);
+	}
+	else if (is_year(credit))
+		record.date = credit;
+	else
+		record.author = credit;
+}
+
+// Whole sidecar with unix line ends. Lines like "Title : Astro Dodge" override what the file name said
+void parse_sidecar( const std::filesystem::path& path, chip8::CatalogueRecord& record )
+{
+	std::ifstream f_notes( path, std::ios::binary );
+	if( !f_notes.is_open() )
+		return;
+
+	std::string line;
+	while (std::getline(f_notes, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		record.notes += line;
+		record.notes += '\n';
+
+		const size_t colon = line.find(':');
+		if (colon == std::string::npos)
+			continue;
+
+		std::string key = trim(line.substr(0, colon));
+		std::transform(key.begin(), key.end(), key.begin(), [](const char& c) { return (char)std::tolower((unsigned char)c); });
+		const std::string value = trim(line.substr(colon + 1));
+		if (value.empty())
+			continue;
+
+		if (key == "title")
+			record.title = value;
+		else if (key == "author")
+			record.author = value;
+		else if (key == "date")
+			record.date = value;
+		else if (key == "system")
+			record.system = value;
+	}
+
+	record.notes = trim(record.notes);
+}
+
+// Sidecar of a rom, shared by its "(alt)" variants
+std::filesystem::path find_sidecar( const std::filesystem::path& rom )
+{
+	std::filesystem::path sidecar = rom;
+	sidecar.replace_extension(".txt");
+	if (std::filesystem::is_regular_file(sidecar))
+		return sidecar;
+
+	std::string stem = rom.stem().string();
+	const std::string alt = " (alt)";
+	if (stem.size() > alt.size() && stem.compare(stem.size() - alt.size(), alt.size(), alt) == 0)
+	{
+		stem.resize(stem.size() - alt.size());
+		sidecar = rom.parent_path() / (stem + ".txt");
+		if (std::filesystem::is_regular_file(sidecar))
+			return sidecar;
+	}
+
+	return {};
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+// Walk, then read and hash each rom once
+bool scan_corpus( const std::string& rom_dir, std::vector<CatalogueRecord>& records )
+{
+	records.clear();
+
+	std::error_code error;
+	std::vector<std::filesystem::path> roms;
+	for (auto it = std::filesystem::recursive_directory_iterator(rom_dir, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		if (it->is_regular_file() && it->path().extension() != ".txt")
+			roms.push_back(it->path());
+	}
+
+	if (error)
+	{
+		util::LOG(LOGTYPE::ERROR, "Directory: " + rom_dir + " failed to read.");
+		return false;
+	}
+
+	std::vector<std::byte> rom;
+	for (const std::filesystem::path& path : roms)
+	{
+		const RomStatus status = read_rom_file(path.string(), rom);
+		if (status != RomStatus::OK)
+		{
+			util::LOG(LOGTYPE::ERROR, "File: " + path.string() + " is no rom, " + to_string(status) + ".");
+			continue;
+		}
+
+		CatalogueRecord record;
+		record.path = std::filesystem::relative(path, rom_dir).generic_string();
+		record.hash = rom_hash(rom);
+		record.modified = modified_ns(std::filesystem::last_write_time(path, error));
+		record.size = (uint32_t)rom.size();
+		record.platform = detect_platform(rom);
+
+		const PlatformProfile profile = platform_profile(record.platform);
+		record.quirks = profile.quirks;
+		record.instructions_per_frame = profile.instructions_per_frame;
+
+		parse_file_name(path, record);
+		const std::filesystem::path sidecar = find_sidecar(path);
+		if (!sidecar.empty())
+			parse_sidecar(sidecar, record);
+
+		records.push_back(std::move(record));
+	}
+
+	// Groups are numbered by the first path holding their contents
+	std::sort(records.begin(), records.end(), [](const CatalogueRecord& a, const CatalogueRecord& b) { return a.path < b.path; });
+
+	std::unordered_map<uint64_t, uint32_t> groups;
+	for (CatalogueRecord& record : records)
+		record.group = groups.emplace(record.hash, (uint32_t)groups.size()).first->second;
+
+	return true;
+}
+
+// Written next to the index and renamed over it, so a reader never sees half an index
+bool write_catalogue( const std::string& path, const std::string& root, const std::vector<CatalogueRecord>& records )
+{
+	std::vector<CatalogueRecord> sorted = records;
+	std::stable_sort(sorted.begin(), sorted.end(), [](const CatalogueRecord& a, const CatalogueRecord& b) { return a.path < b.path; });
+
+	std::string pool;
+	auto add = [&](const std::string& text) {
+		const CatalogueString string{ (uint32_t)pool.size(), (uint32_t)text.size() };
+		pool += text;
+		return string;
+	};
+
+	CatalogueHeader header{};
+	std::memcpy(header.magic, CatalogueHeader::MAGIC, sizeof(header.magic));
+	header.version = CatalogueHeader::VERSION;
+	header.entries = (uint32_t)sorted.size();
+	header.root = add(root);
+
+	std::vector<CatalogueEntry> entries(sorted.size());
+	std::vector<uint32_t> by_hash(sorted.size());
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		const CatalogueRecord& record = sorted[i];
+		CatalogueEntry& entry = entries[i];
+
+		entry = {};
+		entry.hash = record.hash;
+		entry.modified = record.modified;
+		entry.size = record.size;
+		entry.group = record.group;
+		entry.platform = record.platform;
+		entry.quirks = record.quirks;
+		entry.instructions_per_frame = record.instructions_per_frame;
+		entry.path = add(record.path);
+		entry.title = add(record.title);
+		entry.author = add(record.author);
+		entry.date = add(record.date);
+		entry.system = add(record.system);
+		entry.notes = add(record.notes);
+
+		header.groups = std::max(header.groups, record.group + 1);
+		by_hash[i] = (uint32_t)i;
+	}
+	header.pool = (uint32_t)pool.size();
+
+	std::stable_sort(by_hash.begin(), by_hash.end(), [&](const uint32_t& a, const uint32_t& b) { return entries[a].hash < entries[b].hash; });
+
+	const std::string temp = path + ".tmp";
+	{
+		std::ofstream f_index( temp, std::ios::binary | std::ios::trunc );
+		if( !f_index.is_open() )
+		{
+			util::LOG(LOGTYPE::ERROR, "File: " + temp + " failed to open.");
+			return false;
+		}
+
+		f_index.write( (const char*)&header, sizeof(header) );
+		f_index.write( (const char*)entries.data(), (std::streamsize)(entries.size() * sizeof(CatalogueEntry)) );
+		f_index.write( (const char*)by_hash.data(), (std::streamsize)(by_hash.size() * sizeof(uint32_t)) );
+		f_index.write( pool.data(), (std::streamsize)pool.size() );
+
+		if( !f_index.flush() )
+		{
+			util::LOG(LOGTYPE::ERROR, "File: " + temp + " failed to write.");
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp, path, error);
+	if (error)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to replace.");
+		return false;
+	}
+
+	return true;
+}
+
+Catalogue::Catalogue( void ) : m_header(nullptr), m_entries(nullptr), m_by_hash(nullptr), m_pool(nullptr), m_mapping(nullptr), m_mapped_bytes(0)
+{
+}
+
+Catalogue::~Catalogue( void )
+{
+#if defined(__unix__)
+	if (m_mapping)
+		munmap(m_mapping, m_mapped_bytes);
+#endif
+}
+
+// Factory method
+// Uses local struct to dodge private constructor issue for static method
+std::unique_ptr<Catalogue> Catalogue::open_catalogue( const std::string& path )
+{
+	struct MakeUniquePublic : public Catalogue {
+		MakeUniquePublic( void ) : Catalogue() {}
+	};
+
+	std::unique_ptr<Catalogue> catalogue = std::make_unique<MakeUniquePublic>();
+	const char *bytes = nullptr;
+	size_t size = 0;
+
+#if defined(__unix__)
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return nullptr;
+	}
+
+	struct stat info;
+	void *mapping = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(CatalogueHeader))
+		mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not an index.");
+		return nullptr;
+	}
+
+	catalogue->m_mapping = mapping;
+	catalogue->m_mapped_bytes = (size_t)info.st_size;
+	bytes = static_cast<const char *>(mapping);
+	size = (size_t)info.st_size;
+#else
+	std::ifstream f_index( path, std::ios::binary );
+	if( !f_index.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return nullptr;
+	}
+
+	catalogue->m_storage.assign(std::istreambuf_iterator<char>(f_index), std::istreambuf_iterator<char>());
+	bytes = catalogue->m_storage.data();
+	size = catalogue->m_storage.size();
+#endif
+
+	// The header and the hash table are checked here, strings are checked against the pool as they are read
+	const CatalogueHeader *header = reinterpret_cast<const CatalogueHeader *>(bytes);
+	auto needed = [&]() {
+		return sizeof(CatalogueHeader) + (uint64_t)header->entries * (sizeof(CatalogueEntry) + sizeof(uint32_t)) + header->pool;
+	};
+
+	if (size < sizeof(CatalogueHeader) || std::memcmp(header->magic, CatalogueHeader::MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != CatalogueHeader::VERSION || needed() > size)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not an index.");
+		return nullptr;
+	}
+
+	catalogue->m_header = header;
+	catalogue->m_entries = reinterpret_cast<const CatalogueEntry *>(header + 1);
+	catalogue->m_by_hash = reinterpret_cast<const uint32_t *>(catalogue->m_entries + header->entries);
+	catalogue->m_pool = reinterpret_cast<const char *>(catalogue->m_by_hash + header->entries);
+
+	// find(hash) indexes entries with these unchecked
+	for (uint32_t k = 0; k < header->entries; ++k)
+	{
+		if (catalogue->m_by_hash[k] >= header->entries)
+		{
+			util::LOG(LOGTYPE::ERROR, "File: " + path + " is not an index.");
+			return nullptr;
+		}
+	}
+
+	return catalogue;
+}
+
+std::string_view Catalogue::text( const CatalogueString& string ) const
+{
+	if ((uint64_t)string.offset + string.length > m_header->pool)
+		return {};
+	return std::string_view(m_pool + string.offset, string.length);
+}
+
+const CatalogueEntry *Catalogue::find( std::string_view path ) const
+{
+	const CatalogueEntry *end = m_entries + m_header->entries;
+	const CatalogueEntry *found = std::lower_bound(m_entries, end, path, [&](const CatalogueEntry& entry, std::string_view path) {
+		return text(entry.path) < path;
+	});
+
+	return found != end && text(found->path) == path ? found : nullptr;
+}
+
+const CatalogueEntry *Catalogue::find( const uint64_t& hash ) const
+{
+	const uint32_t *end = m_by_hash + m_header->entries;
+	const uint32_t *found = std::lower_bound(m_by_hash, end, hash, [&](const uint32_t& i, const uint64_t& hash) {
+		return m_entries[i].hash < hash;
+	});
+
+	return found != end && m_entries[*found].hash == hash ? &m_entries[*found] : nullptr;
+}
+
+bool Catalogue::stale( const CatalogueEntry& entry ) const
+{
+	const std::filesystem::path path = std::filesystem::path(std::string(root())) / std::string(text(entry.path));
+
+	std::error_code error;
+	const uintmax_t size = std::filesystem::file_size(path, error);
+	if (error || size != entry.size)
+		return true;
+
+	const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+	return error || modified_ns(modified) != entry.modified;
+}
+
+} // namespace chip8
@@ -0,0 +1,183 @@
+// Project includes
+#include "../include/Headless.h"	// Function definitions
+#include "../include/Scheduler.h"	// Frames and timer ticks
+
+// C++ includes
+#include <algorithm>	// For stable sort
+#include <chrono>		// For run time
+#include <istream>		// For input scripts
+#include <ostream>		// For images
+#include <sstream>		// For parsing lines
+
+namespace chip8
+{
+
+// Parse key transitions from a script
+bool parse_input_script(std::istream &in, std::vector<KeyEvent> &events, std::string &error)
+{
+	std::string line;
+	unsigned int line_number = 0;
+
+	while (std::getline(in, line))
+	{
+		++line_number;
+
+		// Strip comments
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream fields(line);
+		uint64_t frame;
+		unsigned int key;
+		std::string state;
+
+		// Skip blank lines
+		if (!(fields >> frame))
+		{
+			if (fields.eof())
+				continue;
+
+			error = "Line " + std::to_string(line_number) + ": expected frame number";
+			return false;
+		}
+
+		if (!(fields >> std::hex >> key) || key > 0xF)
+		{
+			error = "Line " + std::to_string(line_number) + ": expected key 0 to F";
+			return false;
+		}
+
+		if (!(fields >> state) || (state != "down" && state != "up"))
+		{
+			error = "Line " + std::to_string(line_number) + ": expected down or up";
+			return false;
+		}
+
+		events.push_back({frame, (uint8_t)key, state == "down"});
+	}
+
+	// Keep file order for transitions on the same frame
+	std::stable_sort(events.begin(), events.end(), [](const KeyEvent &a, const KeyEvent &b) { return a.frame < b.frame; });
+	return true;
+}
+
+// Run until a limit is hit
+RunStats run_headless(Interpreter &interpreter, const RunLimits &limits, const std::vector<KeyEvent> &script)
+{
+	RunStats stats;
+	std::array<bool, 16> keys = {};
+	size_t next_event = 0;
+
+	// Nothing left in the script that could change what the program does
+	auto script_done = [&]() { return next_event == script.size(); };
+
+	// Jump to self, the program can never leave it. Bnnn can leave the program counter past the end of
+	// memory, where instructions wrap like the interpreter fetches them, so the address is masked first
+	const FlatMemory *flat = dynamic_cast<const FlatMemory *>(&interpreter.memory());
+	auto self_jump = [&]()
+	{
+		const unsigned int pc = interpreter.pc() & FlatMemory::ADR_MASK;
+		const unsigned int opcode = flat ? flat->fetch_opcode(pc)
+										 : ((unsigned int)interpreter.memory().read(pc) << 8) |
+											   (unsigned int)interpreter.memory().read((pc + 1) & FlatMemory::ADR_MASK);
+		return opcode == (0x1000 | pc);
+	};
+
+	// Frames back to back, the run only depends on the rom, the limits and the script
+	SchedulerOptions options;
+	options.instructions_per_frame = limits.instructions_per_frame;
+	options.deterministic = true;
+	FrameScheduler scheduler(interpreter, options);
+
+	// Runs one frame, returns true if the run has to stop
+	auto run_frame = [&]()
+	{
+		// Apply this frame's scripted input
+		while (next_event < script.size() && script[next_event].frame <= stats.frames)
+		{
+			keys[script[next_event].key] = script[next_event].pressed;
+			++next_event;
+		}
+		interpreter.sync_keys(keys);
+
+		uint64_t budget = limits.instructions_per_frame;
+		if (limits.max_cycles != 0)
+			budget = std::min(budget, limits.max_cycles - stats.cycles);
+
+		uint64_t before = interpreter.cycles();
+		Interpreter::RunResult result = scheduler.run_frame(budget);
+		stats.cycles += interpreter.cycles() - before;
+
+		// Nothing to present, just clear the draw flag
+		interpreter.draw();
+
+		if (result == Interpreter::RunResult::EXIT)
+		{
+			stats.reason = StopReason::EXIT;
+			return true;
+		}
+
+		if (limits.max_cycles != 0 && stats.cycles >= limits.max_cycles)
+		{
+			stats.reason = StopReason::CYCLES;
+			return true;
+		}
+
+		// Waiting on a key that will never come, or spinning on a jump to itself
+		if (limits.stop_on_loop && script_done() && (result == Interpreter::RunResult::KEY_WAIT || self_jump()))
+		{
+			stats.reason = StopReason::PC_LOOP;
+			return true;
+		}
+
+		return false;
+	};
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (;;)
+	{
+		if (limits.max_frames != 0 && stats.frames >= limits.max_frames)
+		{
+			stats.reason = StopReason::FRAMES;
+			break;
+		}
+
+		bool stop = run_frame();
+		++stats.frames;
+
+		if (stop)
+			break;
+	}
+
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+// Plain PBM image of the screen
+void write_pbm(std::ostream &out, const Interpreter::FrameView &frame)
+{
+	out << "P1\n" << (unsigned int)frame.width << " " << (unsigned int)frame.height << "\n";
+
+	for (unsigned int y = 0; y < frame.height; ++y)
+	{
+		for (unsigned int x = 0; x < frame.width; ++x)
+			out << ((frame.rows[y][x / 64] >> (63 - x % 64)) & 1 ? '1' : '0');
+		out << "\n";
+	}
+}
+
+// Stop reason names
+const char *to_string(StopReason reason)
+{
+	switch (reason)
+	{
+		case StopReason::CYCLES: return "cycles";
+		case StopReason::FRAMES: return "frames";
+		case StopReason::PC_LOOP: return "pc_loop";
+		case StopReason::EXIT: return "exit";
+	}
+
+	return "unknown";
+}
+
+} // namespace chip8
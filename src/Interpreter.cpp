@@ -1,12 +1,16 @@
 // Project includes
 #include "../include/Logger.h"		// Logger functionality
 #include "../include/Interpreter.h"	// Class definition
+#include "../include/Recompiler.h"	// Optional block translation
 
 // C++ includes
 #include <sstream>	// For stringstream
 #include <string>	// For string
 #include <cstddef>	// C++ standard definitions
-#include <random>	// mt19937 random device
+#include <span>		// Register spans for block memory transfers
+#include <algorithm>	// For min
+#include <bit>		// Rotates for sprite rows
+#include <cstring>	// memmove for scrolls
 
 namespace	/* Module functions */
 {
@@ -18,6 +22,18 @@ std::string opcode_to_hex(const unsigned int &opcode)
 	return stream.str();
 }
 
+// Hex and decimal description of an opcode used in trace and error messages
+std::string opcode_fields(const unsigned int &opcode)
+{
+	return opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") ";
+}
+
+// Per opcode debug trace. Only called once a debug message will actually be written
+std::string opcode_trace(const unsigned int &opcode, const char *description)
+{
+	return "Opcode: " + opcode_fields(opcode) + ", " + description;
+}
+
 // Used for extracting bit fields from opcodes
 unsigned int _v(const unsigned int &in) { return (in & 0xF000) >> 12; }
 unsigned int _vx(const unsigned int &in) { return (in & 0x0F00) >> 8; }
@@ -25,6 +41,21 @@ unsigned int _vy(const unsigned int &in) { return (in & 0x00F0) >> 4; }
 unsigned int _nnn(const unsigned int &in) { return (in & 0x0FFF); }
 unsigned int _nn(const unsigned int &in) { return (in & 0x00FF); }
 unsigned int _n(const unsigned int &in) { return (in & 0x000F); }
+
+// Shift a sprite row right across the two words of a 128 pixel row. What falls off the right edge wraps to the left unless clipping
+chip8::ScreenRow place_sprite(const uint64_t &bits, unsigned int x, const bool &wrap)
+{
+	chip8::ScreenRow row = { bits, 0 };
+	if (x >= 64)
+	{
+		row = { 0, bits };
+		x -= 64;
+	}
+	if (x == 0)
+		return row;
+
+	return { (row[0] >> x) | (wrap ? row[1] << (64 - x) : 0), (row[1] >> x) | (row[0] << (64 - x)) };
+}
 } // anonymous namespace
 
 namespace chip8
@@ -33,42 +64,17 @@ namespace chip8
 // Default constructor that initializes members to default state
 Interpreter::Interpreter()
 {	
-	// Inital program counter value
-	m_program_counter = 0x200;
+	// Keeps counting across resets so a view taken before one still sees the change
+	m_frame_generation = 0;
+	m_seed = DEFAULT_SEED;
+	m_quirks = QUIRKS_NONE;
+	m_handlers = handlers<QUIRKS_NONE>;
 
-	// Other registers
-	m_delay_timer = 0x0;
-	m_sound_timer = 0x0;
-	m_index_register = 0x0;
-	m_sp = 0x0;
+	// No memory until one is moved in
+	m_ram = nullptr;
 
-	// Container initialization
-	m_pixels = {};
-	m_stack = {};
-	m_keys = {};
-	m_registers = {};
-	
-	// Draw and exit flag
-	m_exit_flag = false;
-	m_draw_flag = false;
-
-	// Opcode function table
-	opcodes[0] =  opcode_0xxx;
-	opcodes[1] =  opcode_1nnn; 	
-	opcodes[2] =  opcode_2nnn;
-	opcodes[3] =  opcode_3xnn; 
-	opcodes[4] =  opcode_4xnn; 
-	opcodes[5] =  opcode_5xy0;
-	opcodes[6] =  opcode_6xnn;
-	opcodes[7] =  opcode_7xnn;
-	opcodes[8] =  opcode_8XYx;
-	opcodes[9] =  opcode_9xy0;
-	opcodes[10] = opcode_Annn;
-	opcodes[11] = opcode_Bxnn;
-	opcodes[12] = opcode_Cxnn;
-	opcodes[13] = opcode_Dxyn;
-	opcodes[14] = opcode_EXxx;
-	opcodes[15] = opcode_FXxx;
+	// Registers, containers and flags
+	reset();
 }
 
 // Overloaded constructor
@@ -76,8 +82,20 @@ Interpreter::Interpreter( std::unique_ptr<MemoryMap> memory ) : Interpreter()
 { 
 	// Move the unique memory map into this
 	memory_map = std::move(memory);
+
+	// Use the inlined fast path and predecoding when memory is contiguous
+	m_ram = dynamic_cast<FlatMemory*>(memory_map.get());
+
+	if (m_ram)
+		m_decoded = std::make_unique<std::array<Instruction, FlatMemory::SIZE>>();
+
+	// Where the program starts depends on the rom
+	reset();
 }
 
+// Out of line so the recompiler is a complete type
+Interpreter::~Interpreter() = default;
+
 // Factory method
 // Uses local struct to dodge private constructor issue for static method
 std::unique_ptr<Interpreter> Interpreter::make_interpreter( std::unique_ptr<MemoryMap> memory )
@@ -92,13 +110,44 @@ std::unique_ptr<Interpreter> Interpreter::make_interpreter( std::unique_ptr<Memo
 // Execute next instruction
 void Interpreter::next_instruction( void )
 {
-	// Get opcode without modifying program counter
-	unsigned int opcode = (((unsigned int)memory_map->read(m_program_counter) << 8) |
-													((unsigned int)memory_map->read(m_program_counter + 1)));
-	m_program_counter += 2;
-	execute(opcode);
+	if (m_decoded)
+	{
+		// Decode on first execution of an address, afterwards go straight to the handler
+		Instruction &cached = (*m_decoded)[m_program_counter & FlatMemory::ADR_MASK];
+		if (cached.kind == OP_DECODE)
+			cached = decode(m_ram->fetch_opcode(m_program_counter), m_two_page);
+
+		// Copy so a store over this instruction can not change it mid execution
+		const Instruction op = cached;
+		const unsigned int adr = m_program_counter;
+		if (m_profile)
+			profile(op.kind, adr);
+		m_program_counter += 2;
+		m_handlers[op.kind](this, op);
+		if (m_trace)
+			trace(op, adr);
+	}
+	else
+	{
+		// Get opcode without modifying program counter
+		unsigned int opcode = (((unsigned int)memory_map->read(m_program_counter) << 8) |
+							   ((unsigned int)memory_map->read(m_program_counter + 1)));
+		const Instruction op = decode(opcode, m_two_page);
+		const unsigned int adr = m_program_counter;
+		if (m_profile)
+			profile(op.kind, adr);
+		m_program_counter += 2;
+		m_handlers[op.kind](this, op);
+		if (m_trace)
+			trace(op, adr);
+	}
 
-	// Timer update (Not used)
+	++m_cycle_count;
+}
+
+// Timers count down at 60 Hz, once per frame
+void Interpreter::tick_timers( void )
+{
 	if (m_delay_timer > 0)
 		m_delay_timer -= 1;
 
@@ -106,11 +155,364 @@ void Interpreter::next_instruction( void )
 		m_sound_timer -= 1;
 }
 
+// Recompiler on or off
+bool Interpreter::enable_jit( const bool& enable )
+{
+	if (!enable)
+		m_jit.reset();
+	else if (!m_jit)
+		m_jit = Recompiler::make_recompiler(*this);
+
+	return m_jit != nullptr;
+}
+
+// Batch entry points
+Interpreter::RunResult Interpreter::run_cycles( const uint64_t& cycles )
+{
+	return run(cycles, false);
+}
+
+Interpreter::RunResult Interpreter::run_until_frame( const uint64_t& max_cycles )
+{
+	return run(max_cycles, true);
+}
+
+// Translated blocks when the recompiler is on
+Interpreter::RunResult Interpreter::run( uint64_t cycles, const bool& stop_on_draw )
+{
+	// Translated blocks skip the hooks, so profiling and tracing interpret
+	if (m_jit && !m_profile && !m_trace)
+		return m_jit->run(cycles, stop_on_draw);
+
+	return interpret(cycles, stop_on_draw);
+}
+
+// Instrumented loops only while profiling or tracing
+Interpreter::RunResult Interpreter::interpret( uint64_t cycles, const bool& stop_on_draw )
+{
+	switch ((m_profile ? HOOK_PROFILE : HOOK_NONE) | (m_trace ? HOOK_TRACE : HOOK_NONE))
+	{
+		case HOOK_PROFILE: return dispatch_quirks<HOOK_PROFILE>(cycles, stop_on_draw);
+		case HOOK_TRACE: return dispatch_quirks<HOOK_TRACE>(cycles, stop_on_draw);
+		case HOOK_PROFILE | HOOK_TRACE: return dispatch_quirks<HOOK_PROFILE | HOOK_TRACE>(cycles, stop_on_draw);
+		default: return dispatch_quirks<HOOK_NONE>(cycles, stop_on_draw);
+	}
+}
+
+// One loop per quirk set, set_quirks only accepts these
+template <unsigned int HOOKS>
+Interpreter::RunResult Interpreter::dispatch_quirks( uint64_t cycles, const bool& stop_on_draw )
+{
+	switch (m_quirks)
+	{
+		case QUIRKS_VIP: return dispatch<HOOKS, QUIRKS_VIP>(cycles, stop_on_draw);
+		case QUIRKS_SCHIP: return dispatch<HOOKS, QUIRKS_SCHIP>(cycles, stop_on_draw);
+		case QUIRKS_XOCHIP: return dispatch<HOOKS, QUIRKS_XOCHIP>(cycles, stop_on_draw);
+		default: return dispatch<HOOKS, QUIRKS_NONE>(cycles, stop_on_draw);
+	}
+}
+
+// Only the sets dispatch_quirks has a loop for
+const Interpreter::Handler* Interpreter::quirk_handlers( const uint8_t& quirks )
+{
+	switch (quirks)
+	{
+		case QUIRKS_NONE: return handlers<QUIRKS_NONE>;
+		case QUIRKS_VIP: return handlers<QUIRKS_VIP>;
+		case QUIRKS_SCHIP: return handlers<QUIRKS_SCHIP>;
+		case QUIRKS_XOCHIP: return handlers<QUIRKS_XOCHIP>;
+		default: return nullptr;
+	}
+}
+
+// Handler table and loop of the set, translated blocks were built for the old set
+bool Interpreter::set_quirks( const uint8_t& quirks )
+{
+	const Handler *table = quirk_handlers(quirks);
+	if (!table)
+	{
+		util::LOG(LOGTYPE::ERROR, "Quirk set " + std::to_string(quirks) + " is not compiled in.");
+		return false;
+	}
+
+	m_handlers = table;
+	m_quirks = quirks;
+	if (m_jit)
+		m_jit->flush();
+
+	return true;
+}
+
+// Tight loop over predecoded instructions. With GCC or clang every handler ends in its own
+// indirect jump to the next handler (threaded dispatch), otherwise it falls back to a switch
+template <unsigned int HOOKS, uint8_t QUIRKS>
+Interpreter::RunResult Interpreter::dispatch( uint64_t cycles, const bool& stop_on_draw )
+{
+	m_key_wait = false;
+
+	// No predecoding without flat memory, step one instruction at a time
+	if (!m_decoded)
+	{
+		for (; cycles > 0; --cycles)
+		{
+			next_instruction();
+
+			if (m_exit_flag) return RunResult::EXIT;
+			if (m_key_wait) return RunResult::KEY_WAIT;
+			if (stop_on_draw && m_draw_flag) return RunResult::DRAW;
+		}
+		return RunResult::CYCLES;
+	}
+
+	Instruction op;
+	unsigned int adr;
+	RunResult result = RunResult::CYCLES;
+
+#if defined(__GNUC__)
+	static const void* const labels[OP_COUNT] = {
+		&&L_DECODE,
+#define X(name) &&L_##name,
+		CHIP8_OPCODES(X)
+#undef X
+	};
+#define DISPATCH() goto *labels[op.kind]
+#define TARGET(name) L_##name
+#else
+#define DISPATCH() goto dispatch
+#define TARGET(name) case OP_##name
+#endif
+
+	// Check why we might stop, then fetch the next predecoded instruction
+#define NEXT()																		\
+	do {																			\
+		++m_cycle_count;															\
+		if (m_exit_flag) { result = RunResult::EXIT; goto done; }					\
+		if (m_key_wait) { result = RunResult::KEY_WAIT; goto done; }				\
+		if (stop_on_draw && m_draw_flag) { result = RunResult::DRAW; goto done; }	\
+		if (--cycles == 0) goto done;												\
+		FETCH();																	\
+	} while (0)
+
+#define FETCH()																		\
+	do {																			\
+		adr = m_program_counter;													\
+		op = (*m_decoded)[adr & FlatMemory::ADR_MASK];								\
+		m_program_counter += 2;														\
+		DISPATCH();																	\
+	} while (0)
+
+	if (cycles == 0)
+		return RunResult::CYCLES;
+
+	FETCH();
+
+#if !defined(__GNUC__)
+dispatch:
+	switch (op.kind)
+	{
+#endif
+	TARGET(DECODE):
+	{
+		// First execution since the address was loaded or stored to
+		Instruction &cached = (*m_decoded)[(m_program_counter - 2) & FlatMemory::ADR_MASK];
+		cached = decode(m_ram->fetch_opcode(m_program_counter - 2), m_two_page);
+		op = cached;
+		DISPATCH();
+	}
+#define X(name)																	\
+	TARGET(name):																	\
+		if constexpr (HOOKS & HOOK_PROFILE) profile(OP_##name, adr);				\
+		opcode_##name<QUIRKS>(this, op);											\
+		if constexpr (HOOKS & HOOK_TRACE) trace(op, adr);							\
+		NEXT();
+	CHIP8_OPCODES(X)
+#undef X
+#if !defined(__GNUC__)
+	}
+#endif
+
+#undef FETCH
+#undef NEXT
+#undef TARGET
+#undef DISPATCH
+
+done:
+	return result;
+}
+
 // Separate next_instruction and execute so we can unit test individual opcodes
 void Interpreter::execute( const unsigned int& opcode )
 {
 	// Execute an opcode
-	opcodes[_v(opcode)]( this, opcode );		
+	const Instruction op = decode(opcode, m_two_page);
+	m_handlers[op.kind]( this, op );		
+}
+
+// Power on state. Memory is left alone
+void Interpreter::reset( void )
+{
+	// VIP two page roms jump over the interpreter patch they carry at 0x260 and draw on a 64x64 screen.
+	// Other memory maps may not map the program start, so only flat memory is looked at
+	const bool two_page = m_ram && m_ram->fetch_opcode(PROG_START) == 0x1260;
+	m_two_page = two_page;
+
+	// Inital program counter value
+	m_program_counter = two_page ? 0x2C0 : PROG_START;
+
+	// Other registers
+	m_delay_timer = 0x0;
+	m_sound_timer = 0x0;
+	m_index_register = 0x0;
+	m_sp = 0x0;
+
+	// Container initialization
+	set_resolution(SCRN_WIDTH, two_page ? HIRES_HEIGHT : SCRN_HEIGHT);
+	m_stack = {};
+	m_rpl = {};
+	m_key_mask = 0;
+	m_registers = {};
+	m_random.seed(m_seed);
+	
+	// Draw and exit flag
+	m_exit_flag = false;
+	m_draw_flag = false;
+	m_key_wait = false;
+
+	m_cycle_count = 0;
+
+	// Memory may have been replaced
+	if (m_decoded)
+		m_decoded->fill({});
+
+	if (m_jit)
+		m_jit->flush();
+}
+
+// Expand packed rows into ARGB pixels
+std::vector<uint32_t> Interpreter::screen( void ) const
+{
+	std::vector<uint32_t> pixels(m_width * m_height);
+
+	for (unsigned int y = 0; y < m_height; ++y)
+		for (unsigned int x = 0; x < m_width; ++x)
+			pixels[y * m_width + x] = (m_rows[y][x / 64] >> (63 - x % 64)) & 1 ? 0xFFFFFFFF : 0;
+
+	return pixels;
+}
+
+// Blank screen of the new size, every row is redrawn
+void Interpreter::set_resolution( const uint8_t& width, const uint8_t& height )
+{
+	m_width = width;
+	m_height = height;
+	m_rows = {};
+	m_dirty_rows = ~0ull;
+	++m_frame_generation;
+}
+
+// Rows past the height are always blank
+uint64_t Interpreter::lit_rows( void ) const
+{
+	uint64_t lit = 0;
+	for (unsigned int y = 0; y < m_height; ++y)
+		if (m_rows[y][0] | m_rows[y][1])
+			lit |= uint64_t(1) << y;
+
+	return lit;
+}
+
+// Copy every field into the fixed layout
+bool Interpreter::save_state( SaveState& state ) const
+{
+	if (!m_ram)
+		return false;
+
+	static_assert(std::is_same_v<decltype(state.rows), ScreenRows> && sizeof(state.memory) == FlatMemory::SIZE);
+
+	state.magic = SaveState::MAGIC;
+	state.version = SaveState::VERSION;
+	state.cycles = m_cycle_count;
+	state.seed = m_seed;
+	state.random = m_random.state();
+	state.pc = m_program_counter;
+	state.index = m_index_register;
+	state.sp = m_sp;
+	state.keys = m_key_mask;
+	state.delay = m_delay_timer;
+	state.sound = m_sound_timer;
+	state.flags = (m_exit_flag ? SaveState::EXIT : 0) | (m_draw_flag ? SaveState::DRAW : 0) | (m_key_wait ? SaveState::KEY_WAIT : 0);
+	state.quirks = m_quirks;
+	state.width = m_width;
+	state.height = m_height;
+	std::fill(std::begin(state.reserved), std::end(state.reserved), 0);
+	state.stack = m_stack;
+	state.registers = m_registers;
+	state.rpl = m_rpl;
+	state.rows = m_rows;
+	std::copy(m_ram->data().begin(), m_ram->data().end(), state.memory.begin());
+
+	return true;
+}
+
+// Validate first so a rejected state leaves everything as it was
+bool Interpreter::load_state( const SaveState& state )
+{
+	if (!m_ram || state.magic != SaveState::MAGIC || state.version != SaveState::VERSION || state.sp > m_stack.size())
+		return false;
+
+	const Handler *table = quirk_handlers(state.quirks);
+	const bool size_known = (state.width == SCRN_WIDTH || state.width == HIRES_WIDTH) && (state.height == SCRN_HEIGHT || state.height == HIRES_HEIGHT);
+	if (!table || !size_known)
+		return false;
+
+	m_quirks = state.quirks;
+	m_handlers = table;
+	m_width = state.width;
+	m_height = state.height;
+	m_two_page = m_width == SCRN_WIDTH && m_height == HIRES_HEIGHT;	// Only two page roms draw on a 64x64 screen
+	m_cycle_count = state.cycles;
+	m_seed = state.seed;
+	m_random.set_state(state.random);
+	m_program_counter = state.pc;
+	m_index_register = state.index;
+	m_sp = state.sp;
+	m_key_mask = state.keys;
+	m_delay_timer = state.delay;
+	m_sound_timer = state.sound;
+	m_exit_flag = state.flags & SaveState::EXIT;
+	m_draw_flag = state.flags & SaveState::DRAW;
+	m_key_wait = state.flags & SaveState::KEY_WAIT;
+	m_stack = state.stack;
+	m_registers = state.registers;
+	m_rpl = state.rpl;
+	m_rows = state.rows;
+	m_ram->write_block(0, state.memory);
+
+	// The whole screen and all of memory may differ
+	m_dirty_rows = ~0ull;
+	++m_frame_generation;
+	m_decoded->fill({});
+	if (m_jit)
+		m_jit->flush();
+
+	return true;
+}
+
+// Restart the random sequence
+void Interpreter::seed( const uint64_t& seed )
+{
+	m_seed = seed;
+	m_random.seed(seed);
+}
+
+// Pack gui key states into the mask
+void Interpreter::sync_keys( std::array<bool, 16> t_keys )
+{
+	uint16_t mask = 0;
+	for (unsigned int key = 0; key < t_keys.size(); ++key)
+		mask |= (uint16_t)t_keys[key] << key;
+
+	m_key_mask = mask;
 }
 
 // Draw flag
@@ -121,382 +523,686 @@ bool Interpreter::draw(void)
 	return temp_flag;
 }
 
-// Unit tested
-void Interpreter::opcode_0xxx( Interpreter* cpu, const unsigned int& opcode )
+// Store bytes, then drop predecoded instructions that read any of them
+void Interpreter::mem_store( const unsigned int& adr, std::span<const std::byte> bytes )
+{
+	if (m_ram)
+		m_ram->write_block(adr, bytes);
+	else
+		for (unsigned int i = 0; i < bytes.size(); ++i)
+			memory_map->store(bytes[i], adr + i, true);
+
+	invalidate(adr, bytes.size());
+}
+
+// An opcode at a - 1 reads byte a, so the range starts one address early
+void Interpreter::invalidate( const unsigned int& adr, const size_t& size )
+{
+	if (!m_decoded)
+		return;
+
+	const size_t count = std::min<size_t>(size + 1, FlatMemory::SIZE);
+	for (size_t i = 0; i < count; ++i)
+		(*m_decoded)[(adr - 1 + i) & FlatMemory::ADR_MASK].kind = OP_DECODE;
+
+	if (m_jit)
+		m_jit->invalidate(adr, size);
+}
+
+// Leaf handlers in Op order
+template <uint8_t QUIRKS>
+const Interpreter::Handler Interpreter::handlers[OP_COUNT] = {
+	nullptr,
+#define X(name) opcode_##name<QUIRKS>,
+	CHIP8_OPCODES(X)
+#undef X
+};
+
+// Pick the handler for an opcode and pull out every operand field once
+Interpreter::Instruction Interpreter::decode( const unsigned int& opcode, const bool& two_page )
 {
-	switch(_nn(opcode))
+	Instruction op;
+	op.opcode = opcode;
+	op.nnn = _nnn(opcode);
+	op.x = _vx(opcode);
+	op.y = _vy(opcode);
+	op.n = _n(opcode);
+	op.nn = _nn(opcode);
+	op.kind = OP_unknown;
+
+	switch(_v(opcode))
 	{
-		// Clear screen
-		case 0x00E0:
+		case 0x0:
 		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Clear screen.");
-			cpu->m_pixels.fill(0);
+			// 0230 is the clear screen of the VIP two page interpreter patch, other roms never call it
+			if (op.nn == 0xE0 || (two_page && opcode == 0x0230)) op.kind = OP_00E0;
+			else if (op.nn == 0xEE) op.kind = OP_00EE;
+			else if ((op.nn & 0xF0) == 0xC0) op.kind = OP_00Cn;
+			else if (op.nn == 0xFB) op.kind = OP_00FB;
+			else if (op.nn == 0xFC) op.kind = OP_00FC;
+			else if (op.nn == 0xFD) op.kind = OP_00FD;
+			else if (op.nn == 0xFE) op.kind = OP_00FE;
+			else if (op.nn == 0xFF) op.kind = OP_00FF;
 		} break;
-		// Return from subroutine
-		case 0x00EE:
+		case 0x1: op.kind = OP_1nnn; break;
+		case 0x2: op.kind = OP_2nnn; break;
+		case 0x3: op.kind = OP_3xnn; break;
+		case 0x4: op.kind = OP_4xnn; break;
+		case 0x5: op.kind = OP_5xy0; break;
+		case 0x6: op.kind = OP_6xnn; break;
+		case 0x7: op.kind = OP_7xnn; break;
+		case 0x8:
 		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Return from subroutine.");
-			if( cpu->m_sp != 0)
-				cpu->m_program_counter = cpu->m_stack[--cpu->m_sp];
-			else
-				cpu->m_exit_flag = true;
-			
+			switch(op.n)
+			{
+				case 0x0: op.kind = OP_8xy0; break;
+				case 0x1: op.kind = OP_8xy1; break;
+				case 0x2: op.kind = OP_8xy2; break;
+				case 0x3: op.kind = OP_8xy3; break;
+				case 0x4: op.kind = OP_8xy4; break;
+				case 0x5: op.kind = OP_8xy5; break;
+				case 0x6: op.kind = OP_8xy6; break;
+				case 0x7: op.kind = OP_8xy7; break;
+				case 0xE: op.kind = OP_8xyE; break;
+				default: break;
+			}
+		} break;
+		case 0x9: op.kind = OP_9xy0; break;
+		case 0xA: op.kind = OP_Annn; break;
+		case 0xB: op.kind = OP_Bxnn; break;
+		case 0xC: op.kind = OP_Cxnn; break;
+		case 0xD: op.kind = OP_Dxyn; break;
+		case 0xE:
+		{
+			if (op.nn == 0x9E) op.kind = OP_Ex9E;
+			else if (op.nn == 0xA1) op.kind = OP_ExA1;
 		} break;
-		// Unknown opcode
-		default:{
-			util::LOG(LOGTYPE::ERROR, "Unknown opcode for 0xxx: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") ");
+		case 0xF:
+		{
+			switch(op.nn)
+			{
+				case 0x07: op.kind = OP_Fx07; break;
+				case 0x0A: op.kind = OP_Fx0A; break;
+				case 0x15: op.kind = OP_Fx15; break;
+				case 0x18: op.kind = OP_Fx18; break;
+				case 0x1E: op.kind = OP_Fx1E; break;
+				case 0x29: op.kind = OP_Fx29; break;
+				case 0x30: op.kind = OP_Fx30; break;
+				case 0x33: op.kind = OP_Fx33; break;
+				case 0x55: op.kind = OP_Fx55; break;
+				case 0x65: op.kind = OP_Fx65; break;
+				case 0x75: op.kind = OP_Fx75; break;
+				case 0x85: op.kind = OP_Fx85; break;
+				default: break;
+			}
 		} break;
 	}
+
+	return op;
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00E0( Interpreter* cpu, const Instruction& op )
+{
+	// Clear screen
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Clear screen."); });
+
+	// Only rows with a lit pixel change
+	const uint64_t dirty = cpu->lit_rows();
+	if (dirty)
+	{
+		cpu->m_rows = {};
+		cpu->touch_rows(dirty);
+	}
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00EE( Interpreter* cpu, const Instruction& op )
+{
+	// Return from subroutine
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Return from subroutine."); });
+	if( cpu->m_sp != 0)
+		cpu->m_program_counter = cpu->m_stack[--cpu->m_sp];
+	else
+		cpu->m_exit_flag = true;
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00Cn( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Scroll down n rows at 00Cn."); });
+
+	// Whole rows move, so one memmove. Rows lit before or after are the ones that can differ
+	const unsigned int n = std::min<unsigned int>(op.n, cpu->m_height);
+	const uint64_t lit = cpu->lit_rows();
+	ScreenRow *rows = cpu->m_rows.data();
+	std::memmove(rows + n, rows, (cpu->m_height - n) * sizeof(ScreenRow));
+	std::fill_n(rows, n, ScreenRow{});
+
+	cpu->touch_rows(lit | cpu->lit_rows());
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00FB( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Scroll right 4 pixels at 00FB."); });
+
+	// Pixels shifted past the right edge are dropped. Low resolution scrolls by low resolution pixels
+	const uint64_t lit = cpu->lit_rows();
+	for (unsigned int y = 0; y < cpu->m_height; ++y)
+	{
+		ScreenRow &row = cpu->m_rows[y];
+		row[1] = cpu->m_width == HIRES_WIDTH ? (row[1] >> 4) | (row[0] << 60) : 0;
+		row[0] >>= 4;
+	}
+
+	cpu->touch_rows(lit);
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00FC( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Scroll left 4 pixels at 00FC."); });
+
+	const uint64_t lit = cpu->lit_rows();
+	for (unsigned int y = 0; y < cpu->m_height; ++y)
+	{
+		ScreenRow &row = cpu->m_rows[y];
+		row[0] = (row[0] << 4) | (row[1] >> 60);
+		row[1] <<= 4;
+	}
+
+	cpu->touch_rows(lit);
 }
 
 // Unit tested
-void Interpreter::opcode_1nnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00FD( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Exit interpreter at 00FD."); });
+	cpu->m_exit_flag = true;
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00FE( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Low resolution at 00FE."); });
+	cpu->set_resolution(SCRN_WIDTH, SCRN_HEIGHT);
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_00FF( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "High resolution at 00FF."); });
+	cpu->set_resolution(HIRES_WIDTH, HIRES_HEIGHT);
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_1nnn( Interpreter* cpu, const Instruction& op )
 {
 	// Jump to address NNN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", Jump to address 1NNN.");
-	cpu->m_program_counter = ( _nnn(opcode) );
+	util::LOG<LOGTYPE::DEBUG>([&]{ return "Opcode: " + opcode_to_hex(op.opcode) + ", Jump to address 1NNN."; });
+	cpu->m_program_counter = op.nnn;
 }
 
 // Unit tested
-void Interpreter::opcode_2nnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_2nnn( Interpreter* cpu, const Instruction& op )
 {
 	// Call subroutine at NNN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Call subroutine at 2NNN.");
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Call subroutine at 2NNN."); });
+
+	// Already overflowed, never write past the end of the stack
+	if (cpu->m_sp >= cpu->m_stack.size()) {
+		cpu->m_exit_flag = true;
+		return;
+	}
+
 	cpu->m_stack[cpu->m_sp++] = cpu->m_program_counter;
-	cpu->m_program_counter = _nnn(opcode);
+	cpu->m_program_counter = op.nnn;
 
 	if (cpu->m_sp >= 16) {
-		util::LOG(LOGTYPE::ERROR, "Stack overflow");
+		util::LOG<LOGTYPE::ERROR>([]{ return std::string("Stack overflow"); });
 		cpu->m_exit_flag = true;
 	}
 }
 
 // Unit tested
-void Interpreter::opcode_3xnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_3xnn( Interpreter* cpu, const Instruction& op )
 {
 	// Skip next instruction if VX == NN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instruct if Vx reg == kk at 3xkk.");
-	if(cpu->m_registers[_vx(opcode)] == _nn(opcode))
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instruct if Vx reg == kk at 3xkk."); });
+	if(cpu->m_registers[op.x] == op.nn)
 		cpu->m_program_counter += 2;
 }
 
 // Unit tested
-void Interpreter::opcode_4xnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_4xnn( Interpreter* cpu, const Instruction& op )
 {
 	// Skip next instruction if VX != NN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instruct if Vx reg != kk at 4xkk.");
-	if( cpu->m_registers[_vx(opcode)] != _nn(opcode) )
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instruct if Vx reg != kk at 4xkk."); });
+	if( cpu->m_registers[op.x] != op.nn )
 		cpu->m_program_counter += 2;
 }
 
 // Unit tested
-void Interpreter::opcode_5xy0( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_5xy0( Interpreter* cpu, const Instruction& op )
 {	
 	// Skip next instruction if VX == VY
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instruct if Vx reg == Vy reg at 5xy0.");
-	if(cpu->m_registers[_vx(opcode)] == cpu->m_registers[_vy(opcode)])
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instruct if Vx reg == Vy reg at 5xy0."); });
+	if(cpu->m_registers[op.x] == cpu->m_registers[op.y])
 		cpu->m_program_counter += 2;
 }
 
 // Unit tested
-void Interpreter::opcode_6xnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_6xnn( Interpreter* cpu, const Instruction& op )
 {
 	// Set VX = NN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = nn at 6xnn.");
-	cpu->m_registers[_vx(opcode)] = _nn(opcode)&0x00FF;
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = nn at 6xnn."); });
+	cpu->m_registers[op.x] = op.nn;
 }
 
 // Unit tested
-void Interpreter::opcode_7xnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_7xnn( Interpreter* cpu, const Instruction& op )
 {
 	// Set VX = VX + NN
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx + kk at 7xkk.");
-	cpu->m_registers[_vx(opcode)] += _nn(opcode)&0x00FF;
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx + kk at 7xkk."); });
+	cpu->m_registers[op.x] += op.nn;
 }
 
 // Unit tested
-void Interpreter::opcode_8XYx( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy0( Interpreter* cpu, const Instruction& op )
 {
-	// Reduce function call necessity 
-	unsigned int vx = _vx(opcode), vy = _vy(opcode);
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vy at 8xy0."); });
+	cpu->m_registers[op.x] = cpu->m_registers[op.y];
+}
 
-	switch(opcode & 0x000F)
-	{
-		case 0x0000:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vy at 8xy0.");
-			cpu->m_registers[vx] = cpu->m_registers[vy];
-				
-		} break;
-		case 0x0001:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx or Vy at 8xy1.");
-			cpu->m_registers[vx] |= cpu->m_registers[vy];
-				
-		} break;
-		case 0x0002:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx and Vy at 8xy2.");
-			cpu->m_registers[vx] &= cpu->m_registers[vy];
-				
-		} break;
-		case 0x0003:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx XOR Vy at 8xy3.");
-			cpu->m_registers[vx] ^= cpu->m_registers[vy];
-				
-		} break;
-		case 0x0004:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx + Vy, set Vf = carry at 8xy4.");
-			
-			// After adding the register contents, there needed to be a carry
-			if(cpu->m_registers[vy] + cpu->m_registers[vx] > 0xFF)	// Could use smaller width int but then still need to keep only lower 8 bits
-			{	
-				cpu->m_registers[15] = 1; //carry
-			}
-			else
-				cpu->m_registers[15] = 0;
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy1( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx or Vy at 8xy1."); });
+	cpu->m_registers[op.x] |= cpu->m_registers[op.y];
 
-			cpu->m_registers[vx] += cpu->m_registers[vy];
+	// The VIP's logic routines leave VF clobbered
+	if constexpr (QUIRKS & QUIRK_VF_RESET)
+		cpu->m_registers[15] = 0;
+}
 
-		} break;
-		case 0x0005:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx - Vy, set Vf = NOT borrow at 8xy5.");
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy2( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx and Vy at 8xy2."); });
+	cpu->m_registers[op.x] &= cpu->m_registers[op.y];
 
-			cpu->m_registers[15] = cpu->m_registers[vx] > (cpu->m_registers[vy]); //carry
-			cpu->m_registers[vx] -= cpu->m_registers[vy];
+	// The VIP's logic routines leave VF clobbered
+	if constexpr (QUIRKS & QUIRK_VF_RESET)
+		cpu->m_registers[15] = 0;
+}
 
-		} break;
-		case 0x0006:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx SHR 1 at 8xy6.");
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy3( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx XOR Vy at 8xy3."); });
+	cpu->m_registers[op.x] ^= cpu->m_registers[op.y];
 
-			// If LSB of VX is 1, set carry
-			cpu->m_registers[15] = (cpu->m_registers[vx] & 0x01);
+	// The VIP's logic routines leave VF clobbered
+	if constexpr (QUIRKS & QUIRK_VF_RESET)
+		cpu->m_registers[15] = 0;
+}
 
-			// Divide vx by 2
-			cpu->m_registers[vx] = cpu->m_registers[vx] >> 1;
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy4( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx + Vy, set Vf = carry at 8xy4."); });
+	
+	// After adding the register contents, there needed to be a carry
+	if(cpu->m_registers[op.y] + cpu->m_registers[op.x] > 0xFF)	// Could use smaller width int but then still need to keep only lower 8 bits
+	{	
+		cpu->m_registers[15] = 1; //carry
+	}
+	else
+		cpu->m_registers[15] = 0;
 
-		} break;
-		case 0x0007:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vy - Vx, set Vf = NOT borrow at 8xy7.");
+	cpu->m_registers[op.x] += cpu->m_registers[op.y];
+}
 
-			// Borrow occurs when vx is greater than vy cause vy - vx will be negative
-			if(cpu->m_registers[vy] > (cpu->m_registers[vx]))
-				cpu->m_registers[15] = 1; // carry
-			else
-				cpu->m_registers[15] = 0; 
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy5( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx - Vy, set Vf = NOT borrow at 8xy5."); });
 
-			cpu->m_registers[vx] = (cpu->m_registers[vy] - cpu->m_registers[vx]);
-				
-		} break;
-		case 0x000E:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = Vx SHL 1 at 8xy8.");
+	cpu->m_registers[15] = cpu->m_registers[op.x] > (cpu->m_registers[op.y]); //carry
+	cpu->m_registers[op.x] -= cpu->m_registers[op.y];
+}
 
-			// If MSB of VX is 1, set carry
-			cpu->m_registers[15] = (cpu->m_registers[vx]&0x80) >> 7; // Looks like error
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy6( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx SHR 1 at 8xy6."); });
 
-			// Shift left by one
-			cpu->m_registers[vx] = (cpu->m_registers[vx] << 1) & 0xFF;
-				
-		} break;
-		default:
-		{
-			util::LOG(LOGTYPE::ERROR, "Unknown opcode for 8XYx: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") ");
-		} break;
+	// The VIP shifts Vy into Vx, later interpreters shift Vx in place
+	if constexpr (QUIRKS & QUIRK_SHIFT_VY)
+	{
+		const uint8_t source = cpu->m_registers[op.y];
+		cpu->m_registers[15] = source & 0x01;
+		cpu->m_registers[op.x] = source >> 1;
+		return;
+	}
+
+	// If LSB of VX is 1, set carry
+	cpu->m_registers[15] = (cpu->m_registers[op.x] & 0x01);
+
+	// Divide vx by 2
+	cpu->m_registers[op.x] = cpu->m_registers[op.x] >> 1;
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xy7( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vy - Vx, set Vf = NOT borrow at 8xy7."); });
+
+	// Borrow occurs when vx is greater than vy cause vy - vx will be negative
+	if(cpu->m_registers[op.y] > (cpu->m_registers[op.x]))
+		cpu->m_registers[15] = 1; // carry
+	else
+		cpu->m_registers[15] = 0; 
+
+	cpu->m_registers[op.x] = (cpu->m_registers[op.y] - cpu->m_registers[op.x]);
+}
+
+// Unit tested
+template <uint8_t QUIRKS>
+void Interpreter::opcode_8xyE( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = Vx SHL 1 at 8xy8."); });
+
+	if constexpr (QUIRKS & QUIRK_SHIFT_VY)
+	{
+		const uint8_t source = cpu->m_registers[op.y];
+		cpu->m_registers[15] = source >> 7;
+		cpu->m_registers[op.x] = (source << 1) & 0xFF;
+		return;
 	}
+
+	// If MSB of VX is 1, set carry
+	cpu->m_registers[15] = (cpu->m_registers[op.x]&0x80) >> 7; // Looks like error
+
+	// Shift left by one
+	cpu->m_registers[op.x] = (cpu->m_registers[op.x] << 1) & 0xFF;
 }
 
 // Unit tested
-void Interpreter::opcode_9xy0( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_9xy0( Interpreter* cpu, const Instruction& op )
 {
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instruct if Vx != Vy at 9xy0.");
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instruct if Vx != Vy at 9xy0."); });
 	
-	if( cpu->m_registers[_vx(opcode)] != cpu->m_registers[_vy(opcode)] )
+	if( cpu->m_registers[op.x] != cpu->m_registers[op.y] )
 		cpu->m_program_counter += 2;
 }
 
-void Interpreter::opcode_Annn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Annn( Interpreter* cpu, const Instruction& op )
 {
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set I = nnn at Annn.");
-	cpu->m_index_register = _nnn(opcode);
-	util::LOG(LOGTYPE::DEBUG, "Index register is now: " + std::to_string(_nnn(opcode)));
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set I = nnn at Annn."); });
+	cpu->m_index_register = op.nnn;
+	util::LOG<LOGTYPE::DEBUG>([&]{ return "Index register is now: " + std::to_string(op.nnn); });
 }
 
-void Interpreter::opcode_Bxnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Bxnn( Interpreter* cpu, const Instruction& op )
 {
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Jump to nnn + V0 at Bnnn.");
-	cpu->m_program_counter = ( _nnn(opcode) + cpu->m_registers[0]);
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Jump to nnn + V0 at Bnnn."); });
+	// SUPER-CHIP reads the high nibble of nnn as a register too
+	if constexpr (QUIRKS & QUIRK_JUMP_VX)
+		cpu->m_program_counter = ( op.nnn + cpu->m_registers[op.x]);
+	else
+		cpu->m_program_counter = ( op.nnn + cpu->m_registers[0]);
 }
 
-void Interpreter::opcode_Cxnn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Cxnn( Interpreter* cpu, const Instruction& op )
 {
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = rand byte AND kk Cxkk.");
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = rand byte AND kk Cxkk."); });
 	
-	std::random_device rd;
-	std::mt19937 mt(rd());
-	std::uniform_real_distribution<float> dist(0.0, 256.0);
-
-	cpu->m_registers[_vx(opcode)] = ((unsigned int) dist(mt)) & _nn(opcode);
+	// High bits of a PCG output are its best ones
+	cpu->m_registers[op.x] = (uint8_t)(cpu->m_random() >> 24) & op.nn;
 }
 
-void Interpreter::opcode_Dxyn( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Dxyn( Interpreter* cpu, const Instruction& op )
 {
-	util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Display n byte sprite starting at mem loc I at (Vx, Vy), set Vf = collision at Dxyn.");
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Display n byte sprite starting at mem loc I at (Vx, Vy), set Vf = collision at Dxyn."); });
+
+	// Sprite rows start at the left edge of a row, rotating them to Vx wraps them around the screen.
+	// Clipping shifts instead and drops the rows past the bottom, only the start position wraps.
+	// Dxy0 is a 16x16 sprite of two bytes per row, in either resolution as on XO-CHIP
+	const unsigned int screen_width = cpu->m_width, screen_height = cpu->m_height;
+	const unsigned int Vx = cpu->m_registers[op.x] & (screen_width - 1);
+	const unsigned int sprite_height = op.n ? op.n : 16, row_bytes = op.n ? 1 : 2;
+	unsigned int Vy = cpu->m_registers[op.y];
+	unsigned int height = sprite_height;
+	if constexpr (QUIRKS & QUIRK_CLIP)
+	{
+		Vy &= screen_height - 1;
+		height = std::min(height, screen_height - Vy);
+	}
+	std::array<std::byte, 32> sprite;
+	const auto bytes = std::span(sprite).first(sprite_height * row_bytes);
 
-	// X and Y
-	unsigned int Vx = cpu->m_registers[_vx(opcode)];
-	unsigned int Vy = cpu->m_registers[_vy(opcode)];
-	// Height of pixel based on opcode
-	unsigned int height = _n(opcode);
-	// Pixel row state
-	unsigned short pixel_row = 0;
-	// Carry m_draw_flag
-	cpu->m_registers[15] = 0;
+	if (cpu->m_ram)
+		cpu->m_ram->read_block(cpu->m_index_register, bytes);
+	else
+		for (unsigned int i = 0; i < bytes.size(); ++i)
+			bytes[i] = cpu->memory_map->read(cpu->m_index_register + i);
 
-	for (int y = 0; y < height; ++y)
-	{	
-		// Read state 8 bit pixel row
-		pixel_row = (unsigned short)cpu->memory_map->read( cpu->m_index_register + y );
-
-		// For every bit in pixel row (starting from MSB), check if the bit is set
-		for (int x = 0; x < 8; ++x)
-		{	
-			// Calculate pixel position in array
-			// Pixel x and y positions incooperating screen roll over
-			int px = ((Vx + x) & 63);
-			int py = ((Vy + y) & 31);
-			int pixel_pos = (64 * py) + px;
-			// Set carry flag based on state of pixel at position and the state of the new pixel row
-			cpu->m_registers[15] = (cpu->m_pixels[pixel_pos] > 0) & (pixel_row);
-
-			// If, starting at MSB, pixel is supposed to be set, set the pixel in the array
-			if ((pixel_row & (0x80 >> x)) != 0)
-			{
-				// Set pixel
-				cpu->m_pixels[pixel_pos] ^= 0xFFFFFFFF;
-			}
+	// Set when any lit pixel is turned off
+	uint64_t collision = 0;
+	uint64_t dirty = 0;
+
+	for (unsigned int y = 0; y < height; ++y)
+	{
+		uint64_t bits = (uint64_t)bytes[y * row_bytes] << 56;
+		if (row_bytes == 2)
+			bits |= (uint64_t)bytes[y * row_bytes + 1] << 48;
+
+		const unsigned int py = (Vy + y) & (screen_height - 1);
+		ScreenRow &row = cpu->m_rows[py];
+
+		// Low resolution rows are one word, high resolution rows shift across both
+		if (screen_width == SCRN_WIDTH)
+		{
+			if constexpr (QUIRKS & QUIRK_CLIP)
+				bits >>= Vx;
 			else
-			{
-				// Clear pixel
-				cpu->m_pixels[pixel_pos] ^= 0;
-			}
+				bits = std::rotr(bits, Vx);
+
+			collision |= row[0] & bits;
+			row[0] ^= bits;
+			dirty |= (uint64_t)(bits != 0) << py;
+		}
+		else
+		{
+			const ScreenRow placed = place_sprite(bits, Vx, !(QUIRKS & QUIRK_CLIP));
+
+			collision |= (row[0] & placed[0]) | (row[1] & placed[1]);
+			row[0] ^= placed[0];
+			row[1] ^= placed[1];
+			dirty |= (uint64_t)((placed[0] | placed[1]) != 0) << py;
 		}
 	}
 
+	cpu->m_registers[15] = collision != 0;
+
+	cpu->touch_rows(dirty);
 	cpu->m_draw_flag = true;
 }
 
-void Interpreter::opcode_EXxx( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Ex9E( Interpreter* cpu, const Instruction& op )
 {
-	switch(opcode & 0x00FF)
-	{
-		case 0x009E:{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instrct if key with value Vx is pressed at Ex9E.");
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instrct if key with value Vx is pressed at Ex9E."); });
 
-			if(cpu->m_keys[cpu->m_registers[_vx(opcode)]] == true)
-				cpu->m_program_counter += 2;
-		} break;	
-		case 0x00A1:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Skip next instrct if key with value Vx is not pressed at ExA1.");
+	// Values past 0xF name no key, so they are never pressed
+	const unsigned int key = cpu->m_registers[op.x];
+	if(key < 16 && ((cpu->m_key_mask >> key) & 1))
+		cpu->m_program_counter += 2;
+}
 
-			if(cpu->m_keys[cpu->m_registers[_vx(opcode)]] == false)
-				cpu->m_program_counter += 2;
-		} break;
-		default:
-		{
-			util::LOG(LOGTYPE::ERROR, "Unknown opcode for 9xy0: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") ");
-		} break;
-	}
+template <uint8_t QUIRKS>
+void Interpreter::opcode_ExA1( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Skip next instrct if key with value Vx is not pressed at ExA1."); });
+
+	const unsigned int key = cpu->m_registers[op.x];
+	if(key >= 16 || !((cpu->m_key_mask >> key) & 1))
+		cpu->m_program_counter += 2;
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx07( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set Vx = delay time value at Fx07."); });
+	cpu->m_registers[op.x] = cpu->m_delay_timer;
 }
 
-void Interpreter::opcode_FXxx( Interpreter* cpu, const unsigned int& opcode )
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx0A( Interpreter* cpu, const Instruction& op )
 {
-	switch(opcode & 0x00FF)
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Wait for key press, store value of key in Vx at Fx0A."); });
+	// Prevent moving to the next instruction if none of the keys are pressed
+	if(cpu->m_key_mask == 0)
 	{
-		case 0x0007:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set Vx = delay time value at Fx07.");
-			cpu->m_registers[_vx(opcode)] = cpu->m_delay_timer;
-		} break;	
-		case 0x000A:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Wait for key press, store value of key in Vx at Fx0A.");
-			bool key_press = false;
+		cpu->m_program_counter -= 2;
+		cpu->m_key_wait = true;
+	}
+}
 
-			// Check to see if any key has been pressed
-			// Could compare to a constant array full of falses to iteration time
-			for(const bool& key : cpu->m_keys)
-				key_press |= key;
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx15( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set delay timer = Vx at Fx15."); });
+	cpu->m_delay_timer = cpu->m_registers[op.x];	
+}
 
-			// Prevent moving to the next instruction if none of the keys are pressed
-			if(key_press == false)
-				cpu->m_program_counter -= 2;
-		} break;
-		case 0x0015:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set delay timer = Vx at Fx15.");
-			cpu->m_delay_timer = cpu->m_registers[_vx(opcode)];	
-		} break;
-		case 0x0018:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set sound timer at Fx18.");
-			cpu->m_sound_timer = cpu->m_registers[_vx(opcode)];	
-		} break;
-		case 0x001E:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set I = I + Vx at Fx1E.");
-			// Add vx to index register
-			cpu->m_index_register = ( cpu->m_index_register + cpu->m_registers[_vx( opcode ) ] ) & 0xFFFF;
-		} break;
-		case 0x0029:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set I = location of sprite for digit Vx at Fx29.");
-			// Vx stores a hexidecimal sprite 0x00 to 0x0F and they each take up 5 spots in memory
-			unsigned int vx = _vx(opcode);
-			cpu->m_index_register = cpu->m_registers[vx] * 5;	
-		} break;
-		case 0x0033:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Set BCD rep of Vx in mem loc I, I+1, I+2 at Fx33.");
-			// BCD means we need to take the up to 3 digit long value (max 255) and store each digit in a seperate memory location
-			// Hundreds digit in I, tens in I+i, ones at I+2
-			
-			unsigned int vx_value = cpu->m_registers[_vx(opcode)];
-			cpu->memory_map->store( (std::byte)(vx_value / 100)      , cpu->m_index_register, true);		// Hundreds. Divide by 100, left integer handle rounding
-			cpu->memory_map->store( (std::byte)((vx_value / 10) % 10), cpu->m_index_register + 1, true);		// Tens. Divide by 10, then module base 10
-			cpu->memory_map->store( (std::byte)(vx_value % 10)       , cpu->m_index_register + 2, true);		// Ones. Module base 10	
-		} break;
-		case 0x0055:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Store m_registers V0 through Vx in mem starting at loc I at Fx55.");
-			unsigned int vx = _vx(opcode);
-			
-			// Store register[i]
-			for(int i = 0; i <= vx; ++i)
-				cpu->memory_map->store( (std::byte) cpu->m_registers[i], cpu->m_index_register+i, true);
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx18( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set sound timer at Fx18."); });
+	cpu->m_sound_timer = cpu->m_registers[op.x];	
+}
 
-		} break;
-		case 0x0065:
-		{
-			util::LOG(LOGTYPE::DEBUG, "Opcode: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") " + ", Read m_registers V0 through Vx from mem starting at loc I at Fx65.");
-			unsigned int vx = _vx(opcode);
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx1E( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set I = I + Vx at Fx1E."); });
+	// Add vx to index register
+	cpu->m_index_register = ( cpu->m_index_register + cpu->m_registers[op.x] ) & 0xFFFF;
+}
 
-			for(int i = 0; i <= vx; ++i)
-			{
-				// Read from memory map at ir+index into registers[index]
-				cpu->m_registers[i] = (uint8_t) cpu->memory_map->read( cpu->m_index_register + i );
-			}
-		} break;
-		default:
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx29( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set I = location of sprite for digit Vx at Fx29."); });
+	// Vx stores a hexidecimal sprite 0x00 to 0x0F and they each take up 5 spots in memory
+	cpu->m_index_register = cpu->m_registers[op.x] * 5;	
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx30( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set I = location of big sprite for digit Vx at Fx30."); });
+	// Big digits are 10 rows of 8 pixels
+	cpu->m_index_register = BIG_FONT_START + (cpu->m_registers[op.x] & 0xF) * 10;
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx33( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Set BCD rep of Vx in mem loc I, I+1, I+2 at Fx33."); });
+	// BCD means we need to take the up to 3 digit long value (max 255) and store each digit in a seperate memory location
+	// Hundreds digit in I, tens in I+i, ones at I+2
+	
+	unsigned int vx_value = cpu->m_registers[op.x];
+	const std::array<std::byte, 3> bcd = { (std::byte)(vx_value / 100),			// Hundreds. Divide by 100, left integer handle rounding
+										   (std::byte)((vx_value / 10) % 10),	// Tens. Divide by 10, then module base 10
+										   (std::byte)(vx_value % 10) };		// Ones. Module base 10
+
+	cpu->mem_store(cpu->m_index_register, bcd);
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx55( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Store m_registers V0 through Vx in mem starting at loc I at Fx55."); });
+
+	// Store register[0] through register[x]
+	cpu->mem_store(cpu->m_index_register, std::as_bytes(std::span(cpu->m_registers).first(op.x + 1)));
+
+	if constexpr (QUIRKS & QUIRK_MEMORY_INCREMENT)
+		cpu->m_index_register += op.x + 1;
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx65( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Read m_registers V0 through Vx from mem starting at loc I at Fx65."); });
+
+	if (cpu->m_ram)
+		cpu->m_ram->read_block(cpu->m_index_register, std::as_writable_bytes(std::span(cpu->m_registers).first(op.x + 1)));
+	else
+		for(int i = 0; i <= op.x; ++i)
 		{
-			util::LOG(LOGTYPE::ERROR, "Unknown opcode for FXxx: " + opcode_to_hex(opcode) + ", (" + opcode_to_hex(opcode) + ", (" + std::to_string(opcode) + ")" + ") ");
-		} break;
-	}
+			// Read from memory map at ir+index into registers[index]
+			cpu->m_registers[i] = (uint8_t) cpu->memory_map->read( cpu->m_index_register + i );
+		}
+
+	if constexpr (QUIRKS & QUIRK_MEMORY_INCREMENT)
+		cpu->m_index_register += op.x + 1;
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx75( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Store V0 through Vx in RPL user flags at Fx75."); });
+	std::copy_n(cpu->m_registers.begin(), op.x + 1, cpu->m_rpl.begin());
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_Fx85( Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::DEBUG>([&]{ return opcode_trace(op.opcode, "Read V0 through Vx from RPL user flags at Fx85."); });
+	std::copy_n(cpu->m_rpl.begin(), op.x + 1, cpu->m_registers.begin());
+}
+
+template <uint8_t QUIRKS>
+void Interpreter::opcode_unknown( [[maybe_unused]] Interpreter* cpu, const Instruction& op )
+{
+	util::LOG<LOGTYPE::ERROR>([&]{
+		static const char* const groups[16] = { "0xxx", "1nnn", "2nnn", "3xnn", "4xnn", "5xy0", "6xnn", "7xnn",
+												"8XYx", "9xy0", "Annn", "Bxnn", "Cxnn", "Dxyn", "EXxx", "FXxx" };
+		return std::string("Unknown opcode for ") + groups[_v(op.opcode)] + ": " + opcode_fields(op.opcode);
+	});
 }
 } // end of chip8 namespace
\ No newline at end of file
@@ -1,60 +1,250 @@
 // Project includes
 #include "../include/Logger.h"
+#include "../include/MpscQueue.h"
 
 // C++ includes
+#include <algorithm>
 #include <iostream>
+#include <chrono>
+#include <cstring>
+#include <thread>
 
 namespace util{
 
-// Initial value of static object
-Logger* Logger::m_logger = NULL;
+// Queue shared by every logging thread and the thread writing it out
+struct Logger::Writer
+{
+		// One message, cut to MESSAGE_SIZE characters so records never allocate
+		struct Record
+		{
+				uint8_t level;
+				uint8_t reserved;
+				uint16_t length;
+				char text[MESSAGE_SIZE];
+		};
 
-// Singleton instance function
-Logger* Logger::get_instance( void )
+		chip8::MpscQueue<Record, 1024> queue;
+
+		// Bumped by every push and stop so an idle writer wakes up
+		std::atomic<uint32_t> signal{0};
+
+		// Flushes asked for and flushes done
+		std::atomic<uint64_t> flush_requests{0}, flushes{0};
+
+		// Messages lost to a full queue since the last report
+		std::atomic<uint64_t> dropped{0};
+
+		std::atomic<bool> stop{false};
+		std::atomic<std::ostream*> out{&std::cout};
+
+		std::thread thread;
+
+		// Writer thread body
+		void run( void );
+
+		// Wake the writer
+		void wake( void )
+		{
+				signal.fetch_add(1, std::memory_order_release);
+				signal.notify_one();
+		}
+};
+
+// Drain in batches with one write each. Runs of a message become a count, lines past the rate are only counted
+void Logger::Writer::run( void )
 {
-		if(m_logger == NULL)
+		std::string batch;
+		Record previous{};
+		bool has_previous = false, previous_shown = false;
+		uint64_t repeats = 0, suppressed = 0;
+		unsigned int lines = 0;
+		auto window = std::chrono::steady_clock::now();
+
+		auto append = [&](const uint8_t &level, const char *text, const size_t &length)
+		{
+				batch += static_cast<LOG_LEVEL>(level) == LOG_LEVEL::DEBUG ? "Debug Message: " : "***ERROR*** Message: ";
+				batch.append(text, length);
+				batch += '\n';
+		};
+
+		auto end_run = [&]()
+		{
+				if (repeats == 0)
+						return;
+
+				if (previous_shown)
+				{
+						const std::string text = "Previous message repeated " + std::to_string(repeats) + " times";
+						append(previous.level, text.data(), text.size());
+				}
+				else
+						suppressed += repeats;
+				repeats = 0;
+		};
+
+		auto report_losses = [&]()
+		{
+				if (suppressed > 0)
+				{
+						const std::string text = std::to_string(suppressed) + " log messages suppressed, over " + std::to_string(LINES_PER_SECOND) + " a second";
+						append(static_cast<uint8_t>(LOG_LEVEL::ERROR), text.data(), text.size());
+						suppressed = 0;
+				}
+
+				const uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+				if (lost > 0)
+				{
+						const std::string text = std::to_string(lost) + " log messages dropped, log queue full";
+						append(static_cast<uint8_t>(LOG_LEVEL::ERROR), text.data(), text.size());
+				}
+		};
+
+		for (;;)
 		{
-			m_logger = new Logger();
+				const uint32_t seen = signal.load(std::memory_order_acquire);
+				const uint64_t requested = flush_requests.load(std::memory_order_acquire);
+				const bool stopping = stop.load(std::memory_order_acquire);
+
+				// A new second, so the rate limit starts over
+				const auto now = std::chrono::steady_clock::now();
+				if (now - window >= std::chrono::seconds(1))
+				{
+						end_run();
+						report_losses();
+						window = now;
+						lines = 0;
+				}
+
+				bool popped = false;
+				while (const Record *record = queue.front())
+				{
+						popped = true;
+
+						if (has_previous && record->level == previous.level && record->length == previous.length &&
+							std::memcmp(record->text, previous.text, record->length) == 0)
+						{
+								++repeats;
+								queue.pop();
+								continue;
+						}
+
+						end_run();
+						previous = *record;
+						has_previous = true;
+						previous_shown = lines < LINES_PER_SECOND;
+
+						if (previous_shown)
+						{
+								append(record->level, record->text, record->length);
+								++lines;
+						}
+						else
+								++suppressed;
+
+						queue.pop();
+				}
+
+				// Everything logged before the flush or stop was asked for has been drained
+				const bool flushing = requested != flushes.load(std::memory_order_relaxed);
+				if (flushing || stopping)
+				{
+						end_run();
+						report_losses();
+				}
+
+				if (!batch.empty())
+				{
+						std::ostream &stream = *out.load(std::memory_order_acquire);
+						stream.write(batch.data(), batch.size());
+						stream.flush();
+						batch.clear();
+				}
+
+				if (flushing)
+				{
+						flushes.store(requested, std::memory_order_release);
+						flushes.notify_all();
+				}
+
+				if (stopping)
+						return;
+
+				// Sleep until the next push, flush or stop. Returns at once if one came in since seen was read
+				if (!popped)
+						signal.wait(seen, std::memory_order_acquire);
 		}
+}
+
+// Singleton instance function
+Logger* Logger::get_instance( void )
+{
+		// Constructed once, thread safe, and destroyed at exit after writing what is left
+		static Logger logger;
+		return &logger;
+}
 
-		return m_logger;
+// Start the writer
+Logger::Logger( void ) : m_writer(std::make_unique<Writer>())
+{
+		m_writer->thread = std::thread([writer = m_writer.get()]{ writer->run(); });
 }
 
 // Destructor
 Logger::~Logger( void )
 {
-		delete m_logger;
+		m_writer->stop.store(true, std::memory_order_release);
+		m_writer->wake();
+		m_writer->thread.join();
 }
 
 // Log message based on severity level
-void Logger::log( LOG_LEVEL level, std::string msg ) const 
+void Logger::log( LOG_LEVEL level, std::string msg ) const
 {
 		// Only execute log if input level is greater than or equal to max level
-		if( level >= static_cast<LOG_LEVEL>( max_debug ) )
+		if( !enabled(level) )
+				return;
+
+		Writer::Record record;
+		record.level = static_cast<uint8_t>(level);
+		record.reserved = 0;
+		record.length = static_cast<uint16_t>(std::min(msg.size(), MESSAGE_SIZE));
+		std::memcpy(record.text, msg.data(), record.length);
+
+		// Never wait on the writer, a full queue costs the message
+		if( !m_writer->queue.push(record) )
 		{
-				switch (level) 
-				{
-						case LOG_LEVEL::DEBUG:
-						{
-								std::cout << "Debug Message: " << msg << std::endl;
-						} break;
-						case LOG_LEVEL::ERROR:
-						{
-								std::cout << "***ERROR*** Message: " << msg << std::endl;
-						} break;
-						case LOG_LEVEL::NONE:
-						default:
-						{
-								// Do nothing
-						} break;
-				}
+				m_writer->dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
 		}
+
+		m_writer->wake();
+}
+
+// Ask the writer for a flush and wait for it
+void Logger::flush( void ) const
+{
+		const uint64_t ticket = m_writer->flush_requests.fetch_add(1, std::memory_order_acq_rel) + 1;
+		m_writer->wake();
+
+		uint64_t done = m_writer->flushes.load(std::memory_order_acquire);
+		while( done < ticket )
+		{
+				m_writer->flushes.wait(done, std::memory_order_acquire);
+				done = m_writer->flushes.load(std::memory_order_acquire);
+		}
+}
+
+// Swap streams once the old one has everything
+void Logger::set_output( std::ostream& out )
+{
+		flush();
+		m_writer->out.store(&out, std::memory_order_release);
 }
 
 // Set max log level
 void Logger::set_max_log_level(LOG_LEVEL level)
 {
-		max_debug = static_cast<int>(level);
+		max_debug.store(static_cast<int>(level), std::memory_order_relaxed);
 }
 
 // Helper function outside class to wrap singleton call
@@ -63,4 +253,4 @@ void LOG(Logger::LOG_LEVEL level, std::string msg)
 		Logger::get_instance()->log(level, msg);
 }
 
-} // End of namespace util
\ No newline at end of file
+} // End of namespace util
@@ -8,6 +8,7 @@
 #include <exception>  // For exceptions
 #include <climits>    // For integer limits
 #include <algorithm>  // For sort needed to print unordered map
+#include <cstring>    // For memcpy of flat memory blocks
 
 namespace chip8
 {
@@ -47,8 +48,7 @@ std::byte MemoryMap::read( const unsigned int& adr ) const
     // If address exists, return value. Else, toss an error
     if ( find_result == memory_space.end() )
     {
-        std::string adr_string = " Start: " + std::to_string(start_adr_) + " Requested: " + std::to_string(adr) + " End: " + std::to_string(end_adr_);
-        throw std::out_of_range("Address undefined." + adr_string);
+        throw std::out_of_range("Address undefined." + adr_string_(adr));
     }
     else
     {
@@ -93,16 +93,21 @@ bool MemoryMap::store( const std::byte& val, const unsigned int& adr, const bool
 void MemoryMap::validate_adr_(const unsigned int& adr) const
 {
 
-std::string adr_string = " Start: " + std::to_string(start_adr_) + " Requested: " + std::to_string(adr) + " End: " + std::to_string(end_adr_);
-
+// Only build the message once an address is known to be bad
 if(adr > end_adr_)
-    throw std::out_of_range("Address greater than maximum memory address." + adr_string);
+    throw std::out_of_range("Address greater than maximum memory address." + adr_string_(adr));
 
 if(adr < start_adr_)
-    throw std::out_of_range("Address less than minimum memory address." + adr_string);
+    throw std::out_of_range("Address less than minimum memory address." + adr_string_(adr));
 
 }
 
+// Used for address exception messages
+std::string MemoryMap::adr_string_(const unsigned int& adr) const
+{
+    return " Start: " + std::to_string(start_adr_) + " Requested: " + std::to_string(adr) + " End: " + std::to_string(end_adr_);
+}
+
 // Helper overloaded operator for printing
 std::ostream& operator<<(std::ostream& os, const MemoryMap& dt)
 {
@@ -132,4 +137,66 @@ std::ostream& operator<<(std::ostream& os, const MemoryMap& dt)
     return os;
 }
 
+// Flat memory constructor. Whole address space defined and zeroed
+FlatMemory::FlatMemory( void ) : MemoryMap(SIZE - 1, 0), memory_space_{}
+{
+    // do nothing
+}
+
+// Factory method
+std::unique_ptr<FlatMemory> FlatMemory::makeFlatMemory( void )
+{
+    // Used to dodge problems with private/protected constructors and static functions
+    struct MakeUniquePublic : public FlatMemory {
+      MakeUniquePublic( void ) : FlatMemory() {}
+    };
+
+    return std::make_unique<MakeUniquePublic>();
+}
+
+// Validated store. Every address exists so update flag does not matter
+bool FlatMemory::store( const std::byte& val, const unsigned int& adr, [[maybe_unused]] const bool& update )
+{
+    if( adr >= SIZE )
+        throw std::out_of_range("Address greater than maximum memory address. Requested: " + std::to_string(adr));
+
+    memory_space_[adr] = val;
+    return true;
+}
+
+// Validated read
+std::byte FlatMemory::read( const unsigned int& adr ) const
+{
+    if( adr >= SIZE )
+        throw std::out_of_range("Address greater than maximum memory address. Requested: " + std::to_string(adr));
+
+    return memory_space_[adr];
+}
+
+// Block read, split in two copies if the block runs past the end of memory
+void FlatMemory::read_block( const unsigned int& adr, std::span<std::byte> out ) const noexcept
+{
+    const unsigned int start = adr & ADR_MASK;
+    const size_t first = std::min<size_t>( out.size(), SIZE - start );
+
+    std::memcpy( out.data(), memory_space_.data() + start, first );
+
+    // Anything left over wraps back to address 0
+    for( size_t i = first; i < out.size(); ++i )
+        out[i] = memory_space_[(start + i) & ADR_MASK];
+}
+
+// Block write, split in two copies if the block runs past the end of memory
+void FlatMemory::write_block( const unsigned int& adr, std::span<const std::byte> in ) noexcept
+{
+    const unsigned int start = adr & ADR_MASK;
+    const size_t first = std::min<size_t>( in.size(), SIZE - start );
+
+    std::memcpy( memory_space_.data() + start, in.data(), first );
+
+    // Anything left over wraps back to address 0
+    for( size_t i = first; i < in.size(); ++i )
+        memory_space_[(start + i) & ADR_MASK] = in[i];
+}
+
 } // End of namespace chip8
@@ -0,0 +1,157 @@
+// Project includes
+#include "../include/Movie.h"		// Function declarations
+#include "../include/Logger.h"		// Logger functionality
+#include "../include/Scheduler.h"	// Frames
+
+// C++ includes
+#include <chrono>	// Replay time
+#include <cstring>	// For memcpy
+#include <fstream>	// Movie files
+
+namespace	/* Module functions */
+{
+// Fixed part of a movie file, followed by frames key masks and frames hashes
+struct MovieHeader
+{
+	// "C8MV" read as a little endian word
+	static constexpr uint32_t MAGIC = 0x564D3843;
+	static constexpr uint32_t VERSION = 2;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t instructions_per_frame;
+	uint8_t quirks;
+	uint8_t reserved[3];
+	uint64_t seed;
+	uint64_t start_hash;
+	uint64_t frames;
+};
+
+static_assert(sizeof(MovieHeader) == 40, "Movie header layout changed, bump its VERSION");
+} // anonymous namespace
+
+namespace chip8
+{
+
+// FNV-1a over whole words, then a final avalanche so every input bit reaches every output bit
+uint64_t state_hash(const Interpreter &interpreter)
+{
+	SaveState state;
+	if (!interpreter.save_state(state))
+		return 0;
+
+	static_assert(sizeof(SaveState) % sizeof(uint64_t) == 0);
+	const uint8_t *bytes = (const uint8_t*)&state;
+
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < sizeof(SaveState); i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001B3ull;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+// Same frame loop as a recording, keys set before each frame's first instruction
+ReplayResult play_movie(Interpreter &interpreter, const Movie &movie)
+{
+	ReplayResult result;
+
+	SchedulerOptions options;
+	options.instructions_per_frame = movie.instructions_per_frame;
+	options.deterministic = true;
+	FrameScheduler scheduler(interpreter, options);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	interpreter.seed(movie.seed);
+	const bool quirks = interpreter.set_quirks(movie.quirks);
+	interpreter.reset();
+
+	if (!quirks || state_hash(interpreter) != movie.start_hash)
+		result.desync = true;
+
+	for (size_t frame = 0; !result.desync && frame < movie.keys.size(); ++frame)
+	{
+		interpreter.set_key_mask(movie.keys[frame]);
+		scheduler.run_frame();
+
+		if (frame < movie.hashes.size() && state_hash(interpreter) != movie.hashes[frame])
+			result.desync = true;
+		else
+			++result.frames;
+	}
+
+	result.cycles = interpreter.cycles();
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+// Header, then both arrays in one write each
+bool write_movie(const std::string &path, const Movie &movie)
+{
+	if( movie.keys.size() != movie.hashes.size() )
+	{
+		util::LOG(LOGTYPE::ERROR, "Movie has " + std::to_string(movie.keys.size()) + " key masks but " + std::to_string(movie.hashes.size()) + " hashes.");
+		return false;
+	}
+
+	std::ofstream f_movie( path, std::ios::binary | std::ios::trunc );
+
+	if( !f_movie.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return false;
+	}
+
+	const MovieHeader header = { MovieHeader::MAGIC, MovieHeader::VERSION, movie.instructions_per_frame, movie.quirks, {},
+								 movie.seed, movie.start_hash, movie.keys.size() };
+
+	f_movie.write( (const char*)&header, sizeof(header) );
+	f_movie.write( (const char*)movie.keys.data(), movie.keys.size() * sizeof(uint16_t) );
+	f_movie.write( (const char*)movie.hashes.data(), movie.hashes.size() * sizeof(uint64_t) );
+	return f_movie.good();
+}
+
+// Header checks before sizing the arrays from it
+bool read_movie(const std::string &path, Movie &movie)
+{
+	std::ifstream f_movie( path, std::ios::binary | std::ios::ate );
+
+	if( !f_movie.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return false;
+	}
+
+	const std::streamoff size = f_movie.tellg();
+	MovieHeader header = {};
+
+	f_movie.seekg( 0 );
+	f_movie.read( (char*)&header, sizeof(header) );
+
+	if( !f_movie.good() || header.magic != MovieHeader::MAGIC || header.version != MovieHeader::VERSION || header.frames > (uint64_t)size ||
+		size != (std::streamoff)(sizeof(header) + header.frames * (sizeof(uint16_t) + sizeof(uint64_t))) )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not a version " + std::to_string(MovieHeader::VERSION) + " movie.");
+		return false;
+	}
+
+	movie.seed = header.seed;
+	movie.instructions_per_frame = header.instructions_per_frame;
+	movie.quirks = header.quirks;
+	movie.start_hash = header.start_hash;
+	movie.keys.resize(header.frames);
+	movie.hashes.resize(header.frames);
+
+	f_movie.read( (char*)movie.keys.data(), movie.keys.size() * sizeof(uint16_t) );
+	f_movie.read( (char*)movie.hashes.data(), movie.hashes.size() * sizeof(uint64_t) );
+	return f_movie.good();
+}
+
+} // namespace chip8
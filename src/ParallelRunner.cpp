@@ -0,0 +1,158 @@
+// Project includes
+#include "../include/ParallelRunner.h"	// Function definitions
+
+// C++ includes
+#include <deque>			// Per worker job deques
+#include <map>				// First job of every rom path
+#include <mutex>			// Deque locks
+#include <thread>			// Workers
+
+#ifdef __linux__
+#include <pthread.h>		// Thread affinity
+#include <sched.h>			// Cpu sets
+#endif
+
+namespace	/* Module functions */
+{
+// Job deque of one worker. Own line so owner pops and thief steals do not false share
+struct alignas(64) WorkQueue
+{
+	std::mutex lock;
+	std::deque<size_t> jobs;
+};
+
+// Owner end of a deque
+bool pop_back(WorkQueue &queue, size_t &job)
+{
+	std::lock_guard<std::mutex> guard(queue.lock);
+	if (queue.jobs.empty())
+		return false;
+
+	job = queue.jobs.back();
+	queue.jobs.pop_back();
+	return true;
+}
+
+// Thief end of a deque
+bool steal_front(WorkQueue &queue, size_t &job)
+{
+	std::lock_guard<std::mutex> guard(queue.lock);
+	if (queue.jobs.empty())
+		return false;
+
+	job = queue.jobs.front();
+	queue.jobs.pop_front();
+	return true;
+}
+
+// Pin the calling thread to a cpu
+void pin_to_cpu(unsigned int cpu)
+{
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % CPU_SETSIZE, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)cpu;
+#endif
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+// Run all jobs across the pool
+std::vector<JobResult> run_parallel(const std::vector<Job> &jobs, const ParallelOptions &options)
+{
+	std::vector<JobResult> results(jobs.size());
+
+	unsigned int threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	unsigned int cpus = std::max(1u, std::thread::hardware_concurrency());
+
+	// Map every distinct rom once, identical roms under different paths share an image. Workers only ever read the images
+	RomCache cache;
+	std::vector<std::shared_ptr<const RomImage>> job_images(jobs.size());
+
+	std::map<std::string, size_t> first_job;
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		auto [first, added] = first_job.emplace(jobs[i].rom_path, i);
+		if (added)
+			results[i].rom_status = cache.load(jobs[i].rom_path, job_images[i]);
+		else
+		{
+			results[i].rom_status = results[first->second].rom_status;
+			job_images[i] = job_images[first->second];
+		}
+	}
+
+	// Deal jobs round robin
+	std::vector<WorkQueue> queues(threads);
+	for (size_t i = 0; i < jobs.size(); ++i)
+		queues[i % threads].jobs.push_back(i);
+
+	auto worker = [&](unsigned int id)
+	{
+		if (options.pin_threads)
+			pin_to_cpu(id % cpus);
+
+		// One interpreter per worker, reset between jobs
+		std::unique_ptr<FlatMemory> memory = FlatMemory::makeFlatMemory();
+		FlatMemory &ram = *memory;
+		std::unique_ptr<Interpreter> interpreter = Interpreter::make_interpreter(std::move(memory));
+		interpreter->enable_jit(options.jit);
+
+		for (;;)
+		{
+			size_t job;
+			bool found = pop_back(queues[id], job);
+
+			// Own deque is dry, try everyone else starting with the next worker
+			for (unsigned int offset = 1; !found && offset < threads; ++offset)
+				found = steal_front(queues[(id + offset) % threads], job);
+
+			// Jobs never spawn jobs, so every deque being empty means we are done
+			if (!found)
+				break;
+
+			JobResult &result = results[job];
+			result.worker = id;
+
+			if (result.rom_status != RomStatus::OK)
+				continue;
+
+			load_image(ram, *job_images[job]);
+			interpreter->set_quirks(platform_profile(job_images[job]->platform).quirks);
+
+			if (jobs[job].movie)
+			{
+				// Seeds and resets by itself
+				result.replay = play_movie(*interpreter, *jobs[job].movie);
+				result.stats.cycles = result.replay.cycles;
+				result.stats.frames = result.replay.frames;
+				result.stats.seconds = result.replay.seconds;
+				result.stats.reason = StopReason::FRAMES;
+			}
+			else
+			{
+				// A previous movie may have changed the seed
+				interpreter->seed(Interpreter::DEFAULT_SEED);
+				interpreter->reset();
+				result.stats = run_headless(*interpreter, jobs[job].limits, jobs[job].script);
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int id = 0; id < threads; ++id)
+		pool.emplace_back(worker, id);
+
+	for (auto &thread : pool)
+		thread.join();
+
+	return results;
+}
+
+} // namespace chip8
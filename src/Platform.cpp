@@ -0,0 +1,178 @@
+// Project includes
+#include "../include/Platform.h"	// Function definitions
+#include "../include/Interpreter.h"	// Memory layout constants
+
+// C++ includes
+#include <algorithm>	// For max
+#include <bitset>		// Visited addresses
+#include <vector>		// Paths still to follow
+
+namespace	/* Module functions */
+{
+// Oldest instruction set an opcode belongs to, ordered so the newest one seen wins
+enum class Level { INVALID, CHIP8, SCHIP, XOCHIP };
+
+// Pure function, the second word of F000 nnnn is never classified
+Level classify( const unsigned int& opcode )
+{
+	const unsigned int n = opcode & 0x000F, nn = opcode & 0x00FF;
+
+	switch (opcode >> 12)
+	{
+		case 0x0:
+			// 0000 is padding far more often than a machine code call
+			if (opcode == 0x0000)
+				return Level::INVALID;
+			if ((opcode & 0xFFF0) == 0x00C0 || (opcode >= 0x00FB && opcode <= 0x00FF))
+				return Level::SCHIP;
+			if ((opcode & 0xFFF0) == 0x00D0)
+				return Level::XOCHIP;
+			return Level::CHIP8;
+		case 0x5:
+			return n == 0 ? Level::CHIP8 : n == 2 || n == 3 ? Level::XOCHIP : Level::INVALID;
+		case 0x8:
+			return n <= 0x7 || n == 0xE ? Level::CHIP8 : Level::INVALID;
+		case 0x9:
+			return n == 0 ? Level::CHIP8 : Level::INVALID;
+		case 0xD:
+			return n == 0 ? Level::SCHIP : Level::CHIP8;
+		case 0xE:
+			return nn == 0x9E || nn == 0xA1 ? Level::CHIP8 : Level::INVALID;
+		case 0xF:
+			switch (nn)
+			{
+				case 0x07: case 0x0A: case 0x15: case 0x18: case 0x1E: case 0x29: case 0x33: case 0x55: case 0x65:
+					return Level::CHIP8;
+				case 0x30: case 0x75: case 0x85:
+					return Level::SCHIP;
+				case 0x01: case 0x3A:
+					return Level::XOCHIP;
+				case 0x00: case 0x02:
+					return (opcode & 0x0F00) == 0 ? Level::XOCHIP : Level::INVALID;
+				default:
+					return Level::INVALID;
+			}
+		default:
+			return Level::CHIP8;
+	}
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+const char *to_string( const Platform& platform )
+{
+	switch (platform)
+	{
+		case Platform::CHIP8: return "CHIP-8";
+		case Platform::CHIP8_HIRES: return "CHIP-8 hires";
+		case Platform::SCHIP: return "SUPER-CHIP";
+		case Platform::XOCHIP: return "XO-CHIP";
+	}
+	return "unknown";
+}
+
+// Plain CHIP-8 keeps this interpreter's behaviour, most roms of that era were written for CHIP-48 and SUPER-CHIP
+// interpreters that share it. The two page roms only ever ran on a VIP
+PlatformProfile platform_profile( const Platform& platform )
+{
+	switch (platform)
+	{
+		case Platform::CHIP8_HIRES:
+			return { QUIRKS_VIP, 10 };
+		case Platform::SCHIP:
+			return { QUIRKS_SCHIP, 30 };
+		case Platform::XOCHIP:
+			return { QUIRKS_XOCHIP, 1000 };
+		case Platform::CHIP8:
+		default:
+			return { QUIRKS_NONE, 10 };
+	}
+}
+
+bool parse_quirks( const std::string& name, uint8_t& quirks )
+{
+	if (name == "none")
+		quirks = QUIRKS_NONE;
+	else if (name == "vip")
+		quirks = QUIRKS_VIP;
+	else if (name == "schip")
+		quirks = QUIRKS_SCHIP;
+	else if (name == "xochip")
+		quirks = QUIRKS_XOCHIP;
+	else
+		return false;
+
+	return true;
+}
+
+// Recursive descent over the reachable code, each address is decoded once
+Platform detect_platform( std::span<const std::byte> rom )
+{
+	const size_t end = PROG_START + rom.size();
+
+	// Big endian word at an address, negative outside the rom
+	auto word = [&](const size_t& adr) -> int {
+		if (adr < PROG_START || adr + 1 >= end)
+			return -1;
+		return (std::to_integer<int>(rom[adr - PROG_START]) << 8) | std::to_integer<int>(rom[adr + 1 - PROG_START]);
+	};
+
+	// Two page roms keep a patched VIP interpreter below 0x2C0, their program starts there
+	const bool hires = word(PROG_START) == 0x1260;
+
+	std::bitset<FlatMemory::SIZE> seen;
+	std::vector<size_t> pending{ hires ? 0x2C0u : (size_t)PROG_START };
+	Level newest = Level::CHIP8;
+
+	while (!pending.empty())
+	{
+		size_t adr = pending.back();
+		pending.pop_back();
+
+		while (adr < FlatMemory::SIZE && !seen[adr])
+		{
+			seen[adr] = true;
+
+			const int opcode = word(adr);
+			const Level level = opcode < 0 ? Level::INVALID : classify(opcode);
+			if (level == Level::INVALID)
+				break;
+			newest = std::max(newest, level);
+
+			// Returns, exit and computed jumps end the path
+			if (opcode == 0x00EE || opcode == 0x00FD || (opcode >> 12) == 0xB)
+				break;
+
+			switch (opcode >> 12)
+			{
+				case 0x1:
+					adr = opcode & 0x0FFF;
+					continue;
+				case 0x2:
+					pending.push_back(opcode & 0x0FFF);
+					break;
+				case 0x3: case 0x4: case 0x5: case 0x9: case 0xE:
+					// Skips go over both words of F000 nnnn
+					if (level == Level::CHIP8)
+						pending.push_back(adr + (word(adr + 2) == 0xF000 ? 6 : 4));
+					break;
+				case 0xF:
+					if (opcode == 0xF000)
+						adr += 2;
+					break;
+			}
+			adr += 2;
+		}
+	}
+
+	switch (newest)
+	{
+		case Level::XOCHIP: return Platform::XOCHIP;
+		case Level::SCHIP: return Platform::SCHIP;
+		default: return hires ? Platform::CHIP8_HIRES : Platform::CHIP8;
+	}
+}
+
+} // namespace chip8
@@ -0,0 +1,142 @@
+// Project includes
+#include "../include/Interpreter.h"	// Class definition
+
+// C++ includes
+#include <algorithm>	// Sorting counts
+#include <cstdio>		// snprintf
+#include <iomanip>		// Report columns
+#include <ostream>		// Report output
+#include <vector>		// Hot addresses
+
+namespace chip8
+{
+
+// Counts are dropped by turning it off, so enable always starts from zero
+void Interpreter::enable_profiling( const bool& enable )
+{
+	if (enable)
+		m_profile = std::make_unique<Profile>(Profile{});
+	else
+		m_profile.reset();
+}
+
+// Mnemonics from Cowgod's technical reference, unknown opcodes as raw words
+std::string Interpreter::disassemble( const unsigned int& opcode )
+{
+	const Instruction op = decode(opcode & 0xFFFF);
+	char text[32];
+
+	switch (op.kind)
+	{
+		case OP_00E0: return "CLS";
+		case OP_00EE: return "RET";
+		case OP_00Cn: std::snprintf(text, sizeof(text), "SCD %u", op.n); break;
+		case OP_00FB: return "SCR";
+		case OP_00FC: return "SCL";
+		case OP_00FD: return "EXIT";
+		case OP_00FE: return "LOW";
+		case OP_00FF: return "HIGH";
+		case OP_1nnn: std::snprintf(text, sizeof(text), "JP 0x%03X", op.nnn); break;
+		case OP_2nnn: std::snprintf(text, sizeof(text), "CALL 0x%03X", op.nnn); break;
+		case OP_3xnn: std::snprintf(text, sizeof(text), "SE V%X, 0x%02X", op.x, op.nn); break;
+		case OP_4xnn: std::snprintf(text, sizeof(text), "SNE V%X, 0x%02X", op.x, op.nn); break;
+		case OP_5xy0: std::snprintf(text, sizeof(text), "SE V%X, V%X", op.x, op.y); break;
+		case OP_6xnn: std::snprintf(text, sizeof(text), "LD V%X, 0x%02X", op.x, op.nn); break;
+		case OP_7xnn: std::snprintf(text, sizeof(text), "ADD V%X, 0x%02X", op.x, op.nn); break;
+		case OP_8xy0: std::snprintf(text, sizeof(text), "LD V%X, V%X", op.x, op.y); break;
+		case OP_8xy1: std::snprintf(text, sizeof(text), "OR V%X, V%X", op.x, op.y); break;
+		case OP_8xy2: std::snprintf(text, sizeof(text), "AND V%X, V%X", op.x, op.y); break;
+		case OP_8xy3: std::snprintf(text, sizeof(text), "XOR V%X, V%X", op.x, op.y); break;
+		case OP_8xy4: std::snprintf(text, sizeof(text), "ADD V%X, V%X", op.x, op.y); break;
+		case OP_8xy5: std::snprintf(text, sizeof(text), "SUB V%X, V%X", op.x, op.y); break;
+		case OP_8xy6: std::snprintf(text, sizeof(text), "SHR V%X, V%X", op.x, op.y); break;
+		case OP_8xy7: std::snprintf(text, sizeof(text), "SUBN V%X, V%X", op.x, op.y); break;
+		case OP_8xyE: std::snprintf(text, sizeof(text), "SHL V%X, V%X", op.x, op.y); break;
+		case OP_9xy0: std::snprintf(text, sizeof(text), "SNE V%X, V%X", op.x, op.y); break;
+		case OP_Annn: std::snprintf(text, sizeof(text), "LD I, 0x%03X", op.nnn); break;
+		case OP_Bxnn: std::snprintf(text, sizeof(text), "JP V0, 0x%03X", op.nnn); break;
+		case OP_Cxnn: std::snprintf(text, sizeof(text), "RND V%X, 0x%02X", op.x, op.nn); break;
+		case OP_Dxyn: std::snprintf(text, sizeof(text), "DRW V%X, V%X, %u", op.x, op.y, op.n); break;
+		case OP_Ex9E: std::snprintf(text, sizeof(text), "SKP V%X", op.x); break;
+		case OP_ExA1: std::snprintf(text, sizeof(text), "SKNP V%X", op.x); break;
+		case OP_Fx07: std::snprintf(text, sizeof(text), "LD V%X, DT", op.x); break;
+		case OP_Fx0A: std::snprintf(text, sizeof(text), "LD V%X, K", op.x); break;
+		case OP_Fx15: std::snprintf(text, sizeof(text), "LD DT, V%X", op.x); break;
+		case OP_Fx18: std::snprintf(text, sizeof(text), "LD ST, V%X", op.x); break;
+		case OP_Fx1E: std::snprintf(text, sizeof(text), "ADD I, V%X", op.x); break;
+		case OP_Fx29: std::snprintf(text, sizeof(text), "LD F, V%X", op.x); break;
+		case OP_Fx30: std::snprintf(text, sizeof(text), "LD HF, V%X", op.x); break;
+		case OP_Fx33: std::snprintf(text, sizeof(text), "LD B, V%X", op.x); break;
+		case OP_Fx55: std::snprintf(text, sizeof(text), "LD [I], V%X", op.x); break;
+		case OP_Fx65: std::snprintf(text, sizeof(text), "LD V%X, [I]", op.x); break;
+		case OP_Fx75: std::snprintf(text, sizeof(text), "LD R, V%X", op.x); break;
+		case OP_Fx85: std::snprintf(text, sizeof(text), "LD V%X, R", op.x); break;
+		default: std::snprintf(text, sizeof(text), "DW 0x%04X", op.opcode); break;
+	}
+
+	return text;
+}
+
+// Handlers by count with their share, then the hottest addresses with the opcode memory holds there now
+void Interpreter::write_profile( std::ostream& out, const size_t& top ) const
+{
+	static const char *const names[OP_COUNT] = {
+		"decode",
+#define X(name) #name,
+		CHIP8_OPCODES(X)
+#undef X
+	};
+
+	if (!m_profile)
+	{
+		out << "Profiling is off\n";
+		return;
+	}
+
+	uint64_t total = 0;
+	std::vector<uint8_t> kinds;
+	for (uint8_t kind = 0; kind < OP_COUNT; ++kind)
+	{
+		total += m_profile->ops[kind];
+		if (m_profile->ops[kind] > 0)
+			kinds.push_back(kind);
+	}
+
+	std::sort(kinds.begin(), kinds.end(), [&](const uint8_t &a, const uint8_t &b) { return m_profile->ops[a] > m_profile->ops[b]; });
+
+	const std::ios::fmtflags flags = out.flags();
+	out << total << " instructions\n\nopcode        count   share\n";
+	out << std::fixed << std::setprecision(2);
+	for (const uint8_t &kind : kinds)
+	{
+		out << std::left << std::setw(8) << names[kind] << std::right << std::setw(11) << m_profile->ops[kind]
+			<< std::setw(7) << 100.0 * m_profile->ops[kind] / total << "%\n";
+	}
+
+	std::vector<uint16_t> pcs;
+	for (uint16_t adr = 0; adr < FlatMemory::SIZE; ++adr)
+	{
+		if (m_profile->pcs[adr] > 0)
+			pcs.push_back(adr);
+	}
+
+	const size_t shown = std::min(top, pcs.size());
+	std::partial_sort(pcs.begin(), pcs.begin() + shown, pcs.end(), [&](const uint16_t &a, const uint16_t &b) {
+		return m_profile->pcs[a] > m_profile->pcs[b] || (m_profile->pcs[a] == m_profile->pcs[b] && a < b);
+	});
+
+	out << "\naddress  opcode      count   share  disassembly\n";
+	for (size_t i = 0; i < shown; ++i)
+	{
+		const uint16_t adr = pcs[i];
+		const unsigned int opcode = ((unsigned int)mem_read(adr) << 8) | (unsigned int)mem_read((adr + 1) & FlatMemory::ADR_MASK);
+
+		out << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(3) << adr << "    " << std::setw(4) << opcode
+			<< std::dec << std::setfill(' ') << std::setw(11) << m_profile->pcs[adr] << std::setw(7) << 100.0 * m_profile->pcs[adr] / total
+			<< "%  " << disassemble(opcode) << "\n";
+	}
+
+	out.flags(flags);
+}
+
+} // namespace chip8
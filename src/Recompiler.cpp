@@ -0,0 +1,514 @@
+// Project includes
+#include "../include/Logger.h"		// Logger functionality
+#include "../include/Recompiler.h"	// Class definition
+
+// C++ includes
+#include <cstring>			// For memcpy
+#include <initializer_list>	// Machine code byte lists
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>		// Executable memory
+#define CHIP8_RECOMPILER 1
+#endif
+
+namespace	/* Module functions */
+{
+// Executable memory reserved per recompiler, a full buffer drops every block
+constexpr size_t CODE_SIZE = 4 << 20;
+
+// Longest block in instructions. Short blocks keep run_cycles close to its budget without falling back
+constexpr unsigned int MAX_BLOCK = 32;
+
+// Upper bound of the bytes one block needs
+constexpr size_t MAX_BLOCK_BYTES = MAX_BLOCK * 48 + 256;
+
+// Host registers used by generated code
+constexpr uint8_t EAX = 0, ECX = 1, EDX = 2;
+
+// x86-64 machine code writer. Guest state operands are always [rbx + disp32]
+class Emitter
+{
+  public:
+	Emitter(uint8_t *code, const size_t &at) : m_code(code), m_at(at) {}
+
+	size_t at(void) const { return m_at; }
+
+	void bytes(std::initializer_list<uint8_t> list) { for (uint8_t b : list) m_code[m_at++] = b; }
+	void u32(const uint32_t &value) { std::memcpy(m_code + m_at, &value, 4); m_at += 4; }
+	void u64(const uint64_t &value) { std::memcpy(m_code + m_at, &value, 8); m_at += 8; }
+
+	// Opcode bytes followed by a ModRM for [rbx + disp32] with reg as the register field
+	void rbx(std::initializer_list<uint8_t> op, const uint8_t &reg, const int32_t &disp)
+	{
+		bytes(op);
+		bytes({(uint8_t)(0x80 | (reg << 3) | 3)});
+		u32(disp);
+	}
+
+	// 32 bit displacement from the end of the displacement to target
+	void rel32(const size_t &target) { u32((uint32_t)(int32_t)(target - (m_at + 4))); }
+
+	// Retarget the displacement written at site
+	void patch(const size_t &site, const size_t &target)
+	{
+		const int32_t rel = (int32_t)(target - (site + 4));
+		std::memcpy(m_code + site, &rel, 4);
+	}
+
+	// jmp target
+	void jmp(const size_t &target) { bytes({0xE9}); rel32(target); }
+
+	// jcc target, cc is the low nibble of the condition code
+	void jcc(const uint8_t &cc, const size_t &target) { bytes({0x0F, (uint8_t)(0x80 | cc)}); rel32(target); }
+
+	// mov dword [rbx + disp], imm32
+	void store32(const int32_t &disp, const uint32_t &value) { rbx({0xC7}, 0, disp); u32(value); }
+
+  private:
+	uint8_t *m_code;
+	size_t m_at;
+};
+
+// Condition codes
+constexpr uint8_t CC_A = 0x7, CC_E = 0x4, CC_NE = 0x5;
+
+// Byte distance from an object to one of its members
+int32_t offset_of(const void *object, const void *member)
+{
+	return (int32_t)((const char *)member - (const char *)object);
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+// Factory method
+// Uses local struct to dodge private constructor issue for static method
+std::unique_ptr<Recompiler> Recompiler::make_recompiler( Interpreter& cpu )
+{
+#if defined(CHIP8_RECOMPILER)
+	// Blocks are translated from, and invalidated by, flat memory only
+	if (!cpu.m_ram)
+		return nullptr;
+
+	void *code = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (code == MAP_FAILED)
+	{
+		util::LOG<LOGTYPE::ERROR>([]{ return std::string("Recompiler could not map executable memory"); });
+		return nullptr;
+	}
+
+	struct MakeUniquePublic : public Recompiler {
+		MakeUniquePublic( Interpreter& cpu, uint8_t* code, const size_t& size ) : Recompiler(cpu, code, size) {}
+	};
+
+	return std::make_unique<MakeUniquePublic>( cpu, (uint8_t*)code, CODE_SIZE );
+#else
+	(void)cpu;
+	return nullptr;
+#endif
+}
+
+// Emit the thunks every block shares
+Recompiler::Recompiler( Interpreter& cpu, uint8_t* code, const size_t& size ) : m_cpu(cpu), m_code(code), m_code_size(size), m_stop_on_draw(0), m_translated(0)
+{
+	Emitter e(m_code, 0);
+
+	// uint64_t enter(Interpreter* cpu, uint64_t budget, Recompiler* self, const uint8_t* block)
+	// rbx holds the guest state, r12 the instructions left, r13 this. 16 bytes of stack hold a handler operand
+	m_enter = m_code + e.at();
+	e.bytes({0x53, 0x41, 0x54, 0x41, 0x55});	// push rbx, r12, r13
+	e.bytes({0x48, 0x83, 0xEC, 0x10});			// sub rsp, 16
+	e.bytes({0x48, 0x89, 0xFB});				// mov rbx, rdi
+	e.bytes({0x49, 0x89, 0xF4});				// mov r12, rsi
+	e.bytes({0x49, 0x89, 0xD5});				// mov r13, rdx
+	e.bytes({0xFF, 0xE1});						// jmp rcx
+
+	// Every block leaves through here with the program counter stored, returning the instructions left
+	m_exit = m_code + e.at();
+	e.bytes({0x4C, 0x89, 0xE0});				// mov rax, r12
+	e.bytes({0x48, 0x83, 0xC4, 0x10});			// add rsp, 16
+	e.bytes({0x41, 0x5D, 0x41, 0x5C, 0x5B});	// pop r13, r12, rbx
+	e.bytes({0xC3});							// ret
+
+	m_code_start = e.at();
+	flush();
+}
+
+// Give the executable memory back
+Recompiler::~Recompiler( void )
+{
+#if defined(CHIP8_RECOMPILER)
+	munmap(m_code, m_code_size);
+#endif
+}
+
+// Run translated blocks, finishing with the interpreter whatever the budget or the host can not translate
+Interpreter::RunResult Recompiler::run( uint64_t cycles, const bool& stop_on_draw )
+{
+	using RunResult = Interpreter::RunResult;
+
+	// Flags left set from earlier stop after one instruction and per opcode traces come from the handlers,
+	// the interpreter already gets both right
+	if (m_cpu.m_exit_flag || (stop_on_draw && m_cpu.m_draw_flag) || util::Logger::get_instance()->enabled(LOGTYPE::DEBUG))
+		return m_cpu.interpret(cycles, stop_on_draw);
+
+	typedef uint64_t (*Enter)(Interpreter *cpu, uint64_t budget, Recompiler *self, const uint8_t *block);
+	const Enter enter = reinterpret_cast<Enter>(m_enter);
+
+	m_cpu.m_key_wait = false;
+	m_stop_on_draw = stop_on_draw;
+
+	while (cycles > 0)
+	{
+		const unsigned int pc = m_cpu.m_program_counter;
+		const uint8_t *block = nullptr;
+
+		// The whole opcode has to be inside memory
+		if (pc < FlatMemory::ADR_MASK)
+			block = m_entry[pc] ? m_entry[pc] : compile(pc);
+
+		// Step anything untranslated, and the last few instructions of a budget shorter than the next block
+		if (!block || m_length[pc] > cycles)
+		{
+			const uint64_t steps = block ? cycles : 1;
+			const RunResult result = m_cpu.interpret(steps, stop_on_draw);
+			cycles -= steps;
+
+			if (result != RunResult::CYCLES)
+				return result;
+			continue;
+		}
+
+		cycles = enter(&m_cpu, cycles, this, block);
+
+		if (m_cpu.m_exit_flag) return RunResult::EXIT;
+		if (m_cpu.m_key_wait) return RunResult::KEY_WAIT;
+		if (stop_on_draw && m_cpu.m_draw_flag) return RunResult::DRAW;
+	}
+
+	return RunResult::CYCLES;
+}
+
+// Self-modifying code is rare, so any hit drops everything instead of tracking which blocks read an address
+void Recompiler::invalidate( const unsigned int& adr, const size_t& size )
+{
+	for (size_t i = 0; i < size && i < FlatMemory::SIZE; ++i)
+	{
+		if (m_covered[(adr + i) & FlatMemory::ADR_MASK])
+		{
+			flush();
+			return;
+		}
+	}
+}
+
+// Forget every block. Code after the thunks is only overwritten by the next compile, so a handler
+// that stores over code from inside a block still returns into valid instructions
+void Recompiler::flush( void )
+{
+	m_code_used = m_code_start;
+	m_entry.fill(nullptr);
+	m_length.fill(0);
+	m_covered.reset();
+
+	for (auto &links : m_links)
+		links.clear();
+}
+
+// Translate one basic block. It ends after a jump, a skip, a call into a handler or MAX_BLOCK instructions
+const uint8_t* Recompiler::compile( const unsigned int& pc )
+{
+	using Op = Interpreter::Op;
+	using Instruction = Interpreter::Instruction;
+	static_assert(sizeof(Instruction) <= 16, "Handler operands are copied into a 16 byte stack slot");
+
+	if (m_code_size - m_code_used < MAX_BLOCK_BYTES)
+		flush();
+
+	// Find the block first, its length is checked before anything in it runs
+	std::array<Instruction, MAX_BLOCK> ops;
+	unsigned int count = 0;
+	unsigned int next = pc;
+	bool handler = false, terminated = false;
+
+	while (count < MAX_BLOCK && next < FlatMemory::ADR_MASK)
+	{
+		const Instruction op = Interpreter::decode(m_cpu.m_ram->fetch_opcode(next), m_cpu.m_two_page);
+		ops[count++] = op;
+		next += 2;
+
+		switch (op.kind)
+		{
+			case Op::OP_6xnn: case Op::OP_7xnn:
+			case Op::OP_8xy0: case Op::OP_8xy1: case Op::OP_8xy2: case Op::OP_8xy3:
+			case Op::OP_8xy4: case Op::OP_8xy5: case Op::OP_8xy6: case Op::OP_8xy7: case Op::OP_8xyE:
+			case Op::OP_Annn: case Op::OP_Fx1E: case Op::OP_Fx29:
+				continue;
+			case Op::OP_1nnn:
+			case Op::OP_3xnn: case Op::OP_4xnn: case Op::OP_5xy0: case Op::OP_9xy0:
+				terminated = true;
+				break;
+			default:
+				handler = true;
+				break;
+		}
+		break;
+	}
+
+	// Guest state offsets, generated code addresses everything relative to the interpreter in rbx
+	const Interpreter &cpu = m_cpu;
+	const int32_t V = offset_of(&cpu, &cpu.m_registers);
+	const int32_t VF = V + 15;
+	const int32_t I = offset_of(&cpu, &cpu.m_index_register);
+	const int32_t PC = offset_of(&cpu, &cpu.m_program_counter);
+	const int32_t CYCLES = offset_of(&cpu, &cpu.m_cycle_count);
+	const int32_t EXIT = offset_of(&cpu, &cpu.m_exit_flag);
+	const int32_t KEY_WAIT = offset_of(&cpu, &cpu.m_key_wait);
+	const int32_t DRAW = offset_of(&cpu, &cpu.m_draw_flag);
+	const size_t exit = m_exit - m_code;
+
+	// Blocks are built for the quirk set in use, set_quirks flushes them
+	const uint8_t quirks = cpu.m_quirks;
+
+	Emitter e(m_code, m_code_used);
+	const size_t entry = e.at();
+
+	// Leave for the dispatcher when the budget can not cover the whole block
+	e.bytes({0x49, 0x81, 0xFC}); e.u32(count);		// cmp r12, count
+	e.bytes({0x73, 0x0F});							// jae over the next 15 bytes
+	e.store32(PC, pc);								// mov [pc], block start
+	e.jmp(exit);
+	e.bytes({0x49, 0x81, 0xEC}); e.u32(count);		// sub r12, count
+
+	// Nothing reads the cycle counter while a block runs, so it moves once up front
+	e.rbx({0x48, 0x81}, 0, CYCLES); e.u32(count);	// add qword [cycles], count
+
+	// Leave to target, jumping into its block directly once it is translated
+	auto exit_to = [&](const unsigned int &target) {
+		const bool linkable = target < FlatMemory::ADR_MASK;
+		if (linkable && m_entry[target])
+		{
+			e.jmp(m_entry[target] - m_code);
+			return;
+		}
+
+		// jmp +0, retargeted when the block at target is translated
+		e.bytes({0xE9});
+		if (linkable)
+			m_links[target].push_back((uint32_t)e.at());
+		e.u32(0);
+
+		e.store32(PC, target);
+		e.jmp(exit);
+	};
+
+	// Skip the next instruction when the flags match cc
+	auto skip_if = [&](const uint8_t &cc) {
+		const unsigned int after = pc + 2 * count;
+		e.bytes({0x0F, (uint8_t)(0x80 | (cc ^ 1))});	// Inverted condition jumps to the fall through exit
+		const size_t fall = e.at();
+		e.u32(0);
+		exit_to(after + 2);
+		e.patch(fall, e.at());
+		exit_to(after);
+	};
+
+	// Logic ops clear VF under QUIRK_VF_RESET
+	auto vf_reset = [&]() {
+		if (quirks & QUIRK_VF_RESET)
+		{
+			e.rbx({0xC6}, 0, VF); e.bytes({0x00});		// mov byte [vf], 0
+		}
+	};
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const Instruction &op = ops[i];
+		const int32_t VX = V + op.x;
+		const int32_t VY = V + op.y;
+
+		switch (op.kind)
+		{
+			case Op::OP_6xnn:
+				e.rbx({0xC6}, 0, VX); e.bytes({op.nn});			// mov byte [vx], nn
+				break;
+			case Op::OP_7xnn:
+				e.rbx({0x80}, 0, VX); e.bytes({op.nn});			// add byte [vx], nn
+				break;
+			case Op::OP_8xy0:
+				e.rbx({0x8A}, EAX, VY);							// mov al, [vy]
+				e.rbx({0x88}, EAX, VX);							// mov [vx], al
+				break;
+			case Op::OP_8xy1:
+				e.rbx({0x8A}, EAX, VY);
+				e.rbx({0x08}, EAX, VX);							// or [vx], al
+				vf_reset();
+				break;
+			case Op::OP_8xy2:
+				e.rbx({0x8A}, EAX, VY);
+				e.rbx({0x20}, EAX, VX);							// and [vx], al
+				vf_reset();
+				break;
+			case Op::OP_8xy3:
+				e.rbx({0x8A}, EAX, VY);
+				e.rbx({0x30}, EAX, VX);							// xor [vx], al
+				vf_reset();
+				break;
+
+			// The flag is written before the result and the operands are read again after it,
+			// like the handlers, so x or y being F behaves the same
+			case Op::OP_8xy4:
+				e.rbx({0x0F, 0xB6}, EAX, VX);					// movzx eax, byte [vx]
+				e.rbx({0x0F, 0xB6}, ECX, VY);					// movzx ecx, byte [vy]
+				e.bytes({0x01, 0xC8});							// add eax, ecx
+				e.bytes({0x3D}); e.u32(0xFF);					// cmp eax, 0xFF
+				e.bytes({0x0F, 0x97, 0xC2});					// seta dl
+				e.rbx({0x88}, EDX, VF);							// mov [vf], dl
+				e.rbx({0x8A}, EAX, VY);							// mov al, [vy]
+				e.rbx({0x00}, EAX, VX);							// add [vx], al
+				break;
+			case Op::OP_8xy5:
+				e.rbx({0x8A}, EAX, VX);							// mov al, [vx]
+				e.rbx({0x3A}, EAX, VY);							// cmp al, [vy]
+				e.bytes({0x0F, 0x97, 0xC2});					// seta dl
+				e.rbx({0x88}, EDX, VF);
+				e.rbx({0x8A}, EAX, VY);
+				e.rbx({0x28}, EAX, VX);							// sub [vx], al
+				break;
+			case Op::OP_8xy6:
+				if (quirks & QUIRK_SHIFT_VY)
+				{
+					e.rbx({0x8A}, EAX, VY);							// mov al, [vy]
+					e.bytes({0x88, 0xC2});							// mov dl, al
+					e.bytes({0x80, 0xE2, 0x01});					// and dl, 1
+					e.rbx({0x88}, EDX, VF);							// mov [vf], dl
+					e.bytes({0xD0, 0xE8});							// shr al, 1
+					e.rbx({0x88}, EAX, VX);							// mov [vx], al
+					break;
+				}
+				e.rbx({0x8A}, EAX, VX);
+				e.bytes({0x24, 0x01});							// and al, 1
+				e.rbx({0x88}, EAX, VF);
+				e.rbx({0xD0}, 5, VX);							// shr byte [vx], 1
+				break;
+			case Op::OP_8xy7:
+				e.rbx({0x8A}, EAX, VY);							// mov al, [vy]
+				e.rbx({0x3A}, EAX, VX);							// cmp al, [vx]
+				e.bytes({0x0F, 0x97, 0xC2});					// seta dl
+				e.rbx({0x88}, EDX, VF);
+				e.rbx({0x8A}, EAX, VY);
+				e.rbx({0x2A}, EAX, VX);							// sub al, [vx]
+				e.rbx({0x88}, EAX, VX);
+				break;
+			case Op::OP_8xyE:
+				if (quirks & QUIRK_SHIFT_VY)
+				{
+					e.rbx({0x8A}, EAX, VY);
+					e.bytes({0x88, 0xC2});
+					e.bytes({0xC0, 0xEA, 0x07});					// shr dl, 7
+					e.rbx({0x88}, EDX, VF);
+					e.bytes({0xD0, 0xE0});							// shl al, 1
+					e.rbx({0x88}, EAX, VX);
+					break;
+				}
+				e.rbx({0x8A}, EAX, VX);
+				e.bytes({0xC0, 0xE8, 0x07});					// shr al, 7
+				e.rbx({0x88}, EAX, VF);
+				e.rbx({0xD0}, 4, VX);							// shl byte [vx], 1
+				break;
+			case Op::OP_Annn:
+				e.store32(I, op.nnn);							// mov dword [i], nnn
+				break;
+			case Op::OP_Fx1E:
+				e.rbx({0x0F, 0xB6}, EAX, VX);					// movzx eax, byte [vx]
+				e.rbx({0x03}, EAX, I);							// add eax, [i]
+				e.bytes({0x0F, 0xB7, 0xC0});					// movzx eax, ax
+				e.rbx({0x89}, EAX, I);							// mov [i], eax
+				break;
+			case Op::OP_Fx29:
+				e.rbx({0x0F, 0xB6}, EAX, VX);
+				e.bytes({0x8D, 0x04, 0x80});					// lea eax, [rax + rax * 4]
+				e.rbx({0x89}, EAX, I);
+				break;
+
+			case Op::OP_1nnn:
+				exit_to(op.nnn);
+				break;
+			case Op::OP_3xnn:
+				e.rbx({0x80}, 7, VX); e.bytes({op.nn});			// cmp byte [vx], nn
+				skip_if(CC_E);
+				break;
+			case Op::OP_4xnn:
+				e.rbx({0x80}, 7, VX); e.bytes({op.nn});
+				skip_if(CC_NE);
+				break;
+			case Op::OP_5xy0:
+				e.rbx({0x8A}, EAX, VX);
+				e.rbx({0x3A}, EAX, VY);							// cmp al, [vy]
+				skip_if(CC_E);
+				break;
+			case Op::OP_9xy0:
+				e.rbx({0x8A}, EAX, VX);
+				e.rbx({0x3A}, EAX, VY);
+				skip_if(CC_NE);
+				break;
+
+			// Everything else runs its interpreter handler with the program counter already past it
+			default:
+			{
+				uint64_t operand[2] = {};
+				std::memcpy(operand, &op, sizeof(op));
+
+				e.store32(PC, pc + 2 * count);
+				e.bytes({0x48, 0xB8}); e.u64(operand[0]);					// mov rax, operand
+				e.bytes({0x48, 0x89, 0x04, 0x24});							// mov [rsp], rax
+				e.bytes({0x48, 0xB8}); e.u64(operand[1]);
+				e.bytes({0x48, 0x89, 0x44, 0x24, 0x08});					// mov [rsp + 8], rax
+				e.bytes({0x48, 0x89, 0xE6});								// mov rsi, rsp
+				e.bytes({0x48, 0x89, 0xDF});								// mov rdi, rbx
+				e.bytes({0x48, 0xB8}); e.u64(reinterpret_cast<uint64_t>(m_cpu.m_handlers[op.kind]));
+				e.bytes({0xFF, 0xD0});										// call rax
+
+				// Return to the dispatcher for anything that stops a run
+				e.rbx({0x80}, 7, EXIT); e.bytes({0x00});					// cmp byte [exit], 0
+				e.jcc(CC_NE, exit);
+				e.rbx({0x80}, 7, KEY_WAIT); e.bytes({0x00});
+				e.jcc(CC_NE, exit);
+				e.rbx({0x8A}, EAX, DRAW);									// mov al, [draw]
+				e.bytes({0x41, 0x22, 0x85}); e.u32(offset_of(this, &m_stop_on_draw));	// and al, [r13 + stop]
+				e.jcc(CC_NE, exit);
+
+				// The handler picked the program counter, continue in its block if there is one
+				e.rbx({0x8B}, EAX, PC);										// mov eax, [pc]
+				e.bytes({0x3D}); e.u32(FlatMemory::ADR_MASK - 1);			// cmp eax, last opcode address
+				e.jcc(CC_A, exit);
+				e.bytes({0x49, 0x8B, 0x84, 0xC5}); e.u32(offset_of(this, m_entry.data()));	// mov rax, [r13 + rax * 8 + entry]
+				e.bytes({0x48, 0x85, 0xC0});								// test rax, rax
+				e.jcc(CC_E, exit);
+				e.bytes({0xFF, 0xE0});										// jmp rax
+			} break;
+		}
+	}
+
+	// Ran into MAX_BLOCK or the end of memory
+	if (!handler && !terminated)
+		exit_to(pc + 2 * count);
+
+	m_code_used = e.at();
+	m_entry[pc] = m_code + entry;
+	m_length[pc] = count;
+
+	for (unsigned int adr = pc; adr < pc + 2 * count; ++adr)
+		m_covered[adr] = true;
+
+	// Blocks that were waiting for this one now jump straight in
+	for (const uint32_t &site : m_links[pc])
+		e.patch(site, entry);
+	m_links[pc].clear();
+
+	++m_translated;
+	return m_entry[pc];
+}
+
+} // end of chip8 namespace
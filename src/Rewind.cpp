@@ -0,0 +1,184 @@
+// Project includes
+#include "../include/Rewind.h"	// Class definition
+
+// C++ includes
+#include <algorithm>	// For copy
+#include <cstring>		// For memcpy
+
+namespace	/* Module functions */
+{
+// Bytes in a state
+constexpr size_t STATE_SIZE = sizeof(chip8::SaveState);
+
+// Base of keyframes
+const chip8::SaveState ZERO_STATE = {};
+
+// Equal runs shorter than this stay inside a literal, a new run header would cost more
+constexpr size_t MIN_RUN = 4;
+
+// Append a 16 bit run length. States are smaller than 64 KB
+void put_length(std::vector<uint8_t> &out, const size_t &length)
+{
+	out.push_back(length & 0xFF);
+	out.push_back(length >> 8);
+}
+
+uint16_t get_length(const uint8_t *&in)
+{
+	const uint16_t length = in[0] | (in[1] << 8);
+	in += 2;
+	return length;
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+static_assert(sizeof(SaveState) < 0x10000, "Run lengths are 16 bits");
+
+RewindBuffer::RewindBuffer( const size_t& capacity, const size_t& keyframe_interval ) : m_capacity(capacity), m_keyframe_interval(std::max<size_t>(keyframe_interval, 1)), m_size(0), m_bytes(0), m_keyframe()
+{
+}
+
+// Records are pairs of an equal run length and a literal length followed by the literal XOR bytes
+void RewindBuffer::encode( const uint8_t* state, const uint8_t* base, std::vector<uint8_t>& out )
+{
+	size_t i = 0;
+	while (i < STATE_SIZE)
+	{
+		// Equal bytes, a word at a time while whole words match
+		size_t equal = i;
+		while (equal + 8 <= STATE_SIZE && std::memcmp(state + equal, base + equal, 8) == 0)
+			equal += 8;
+		while (equal < STATE_SIZE && state[equal] == base[equal])
+			++equal;
+
+		// Changed bytes, absorbing equal runs too short to be worth a header
+		size_t end = equal;
+		while (end < STATE_SIZE)
+		{
+			if (state[end] != base[end])
+			{
+				++end;
+				continue;
+			}
+
+			size_t run = end;
+			while (run < STATE_SIZE && run - end < MIN_RUN && state[run] == base[run])
+				++run;
+			if (run - end >= MIN_RUN || run == STATE_SIZE)
+				break;
+			end = run;
+		}
+
+		put_length(out, equal - i);
+		put_length(out, end - equal);
+		for (size_t j = equal; j < end; ++j)
+			out.push_back(state[j] ^ base[j]);
+
+		i = end;
+	}
+}
+
+// Start from base and XOR the literals back in
+void RewindBuffer::decode( const uint8_t* record, const uint8_t* base, uint8_t* state )
+{
+	std::memcpy(state, base, STATE_SIZE);
+
+	size_t i = 0;
+	while (i < STATE_SIZE)
+	{
+		i += get_length(record);
+		const uint16_t literal = get_length(record);
+
+		for (uint16_t j = 0; j < literal; ++j)
+			state[i + j] ^= record[j];
+
+		record += literal;
+		i += literal;
+	}
+}
+
+void RewindBuffer::push( const SaveState& state )
+{
+	// New group. Take the oldest one's storage when the history is full
+	if (m_groups.empty() || m_groups.back().ends.size() == m_keyframe_interval)
+	{
+		Group group;
+		if (!m_groups.empty() && m_size - m_groups.front().ends.size() >= m_capacity)
+		{
+			group = std::move(m_groups.front());
+			m_groups.pop_front();
+			m_size -= group.ends.size();
+			m_bytes -= group.data.size();
+		}
+		else if (!m_spare.empty())
+		{
+			group = std::move(m_spare.back());
+			m_spare.pop_back();
+		}
+
+		group.data.clear();
+		group.ends.clear();
+		m_groups.push_back(std::move(group));
+
+		encode((const uint8_t*)&state, (const uint8_t*)&ZERO_STATE, m_groups.back().data);
+		m_keyframe = state;
+	}
+	else
+	{
+		encode((const uint8_t*)&state, (const uint8_t*)&m_keyframe, m_groups.back().data);
+	}
+
+	Group &newest = m_groups.back();
+	m_bytes += newest.data.size() - (newest.ends.empty() ? 0 : newest.ends.back());
+	newest.ends.push_back(newest.data.size());
+	++m_size;
+}
+
+bool RewindBuffer::pop( SaveState& state )
+{
+	if (m_size == 0)
+		return false;
+
+	Group &newest = m_groups.back();
+	const uint32_t begin = newest.ends.size() > 1 ? newest.ends[newest.ends.size() - 2] : 0;
+	const uint8_t *base = newest.ends.size() > 1 ? (const uint8_t*)&m_keyframe : (const uint8_t*)&ZERO_STATE;
+
+	decode(newest.data.data() + begin, base, (uint8_t*)&state);
+
+	m_bytes -= newest.data.size() - begin;
+	newest.data.resize(begin);
+	newest.ends.pop_back();
+	--m_size;
+
+	// Keyframe gone, continue from the previous group
+	if (newest.ends.empty())
+	{
+		m_spare.push_back(std::move(newest));
+		m_groups.pop_back();
+		load_keyframe();
+	}
+
+	return true;
+}
+
+void RewindBuffer::clear( void )
+{
+	while (!m_groups.empty())
+	{
+		m_spare.push_back(std::move(m_groups.back()));
+		m_groups.pop_back();
+	}
+
+	m_size = 0;
+	m_bytes = 0;
+}
+
+void RewindBuffer::load_keyframe( void )
+{
+	if (!m_groups.empty())
+		decode(m_groups.back().data.data(), (const uint8_t*)&ZERO_STATE, (uint8_t*)&m_keyframe);
+}
+
+} // namespace chip8
@@ -0,0 +1,281 @@
+// Project includes
+#include "../include/Rom.h"			// Function definitions
+#include "../include/Interpreter.h"	// Memory layout constants
+
+// C++ includes
+#include <algorithm>	// For min
+#include <cerrno>		// Why a file failed to open
+#include <cstring>		// memcpy
+#include <fstream>		// For reading the rom
+#include <span>			// For block writes
+#include <vector>		// Rom bytes
+
+#if defined(__unix__)
+#include <fcntl.h>		// open
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// read, close
+#else
+#include <filesystem>	// Telling a missing file from an unreadable one
+#endif
+
+namespace	/* Module functions */
+{
+// Largest rom that fits above the program start
+constexpr size_t MAX_ROM_SIZE = chip8::FlatMemory::SIZE - chip8::PROG_START;
+
+// Whole rom file in a fixed buffer. Roms are at most a few KB, where one read beats mapping the file,
+// since a mapping pays a page fault and a TLB flush on unmap for the same single copy
+class RomFile
+{
+  public:
+	// Size checks happen before anything is read
+	chip8::RomStatus open(const std::string &path)
+	{
+#if defined(__unix__)
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return errno == ENOENT ? chip8::RomStatus::NOT_FOUND : chip8::RomStatus::UNREADABLE;
+
+		struct stat info;
+		chip8::RomStatus status = chip8::RomStatus::OK;
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+			status = chip8::RomStatus::UNREADABLE;
+		else if (info.st_size == 0)
+			status = chip8::RomStatus::EMPTY;
+		else if ((size_t)info.st_size > MAX_ROM_SIZE)
+			status = chip8::RomStatus::TOO_LARGE;
+		else
+		{
+			// Regular files return everything asked for unless interrupted, so loop on short reads
+			m_size = 0;
+			while (m_size < (size_t)info.st_size)
+			{
+				const ssize_t got = ::read(fd, m_buffer.data() + m_size, (size_t)info.st_size - m_size);
+				if (got < 0 && errno == EINTR)
+					continue;
+				if (got <= 0)
+				{
+					status = chip8::RomStatus::UNREADABLE;
+					break;
+				}
+				m_size += (size_t)got;
+			}
+		}
+
+		close(fd);
+		return status;
+#else
+		std::ifstream f_rom( path, std::ios::binary | std::ios::ate );
+		if( !f_rom.is_open() )
+			return std::filesystem::exists(path) ? chip8::RomStatus::UNREADABLE : chip8::RomStatus::NOT_FOUND;
+
+		const std::streamoff size = f_rom.tellg();
+		if (size <= 0)
+			return size == 0 ? chip8::RomStatus::EMPTY : chip8::RomStatus::UNREADABLE;
+		if ((size_t)size > MAX_ROM_SIZE)
+			return chip8::RomStatus::TOO_LARGE;
+
+		f_rom.seekg( 0 );
+		f_rom.read( (char*)m_buffer.data(), size );
+		if (!f_rom)
+			return chip8::RomStatus::UNREADABLE;
+
+		m_size = (size_t)size;
+		return chip8::RomStatus::OK;
+#endif
+	}
+
+	// Whole file, valid while this lives
+	std::span<const std::byte> bytes(void) const { return std::span(m_buffer).first(m_size); }
+
+  private:
+	std::array<std::byte, MAX_ROM_SIZE> m_buffer;
+	size_t m_size = 0;
+};
+} // anonymous namespace
+
+namespace chip8
+{
+
+// Chip8 fontset loaded into each rom at the start
+const std::array<uint8_t, 80> FONTSET = 
+{
+	0xF0, 0x90, 0x90, 0x90, 0xF0, //0
+	0x20, 0x60, 0x20, 0x20, 0x70, //1
+	0xF0, 0x10, 0xF0, 0x80, 0xF0, //2
+	0xF0, 0x10, 0xF0, 0x10, 0xF0, //3
+	0x90, 0x90, 0xF0, 0x10, 0x10, //4
+	0xF0, 0x80, 0xF0, 0x10, 0xF0, //5
+	0xF0, 0x80, 0xF0, 0x90, 0xF0, //6
+	0xF0, 0x10, 0x20, 0x40, 0x40, //7
+	0xF0, 0x90, 0xF0, 0x90, 0xF0, //8
+	0xF0, 0x90, 0xF0, 0x10, 0xF0, //9
+	0xF0, 0x90, 0xF0, 0x90, 0x90, //A
+	0xE0, 0x90, 0xE0, 0x90, 0xE0, //B
+	0xF0, 0x80, 0x80, 0x80, 0xF0, //C
+	0xE0, 0x90, 0x90, 0x90, 0xE0, //D
+	0xF0, 0x80, 0xF0, 0x80, 0xF0, //E
+	0xF0, 0x80, 0xF0, 0x80, 0x80  //F
+};
+
+// SUPER-CHIP 8x10 digits, with Octo's A to F
+const std::array<uint8_t, 160> BIG_FONTSET =
+{
+	0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, //0
+	0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, //1
+	0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, //2
+	0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, //3
+	0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, //4
+	0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, //5
+	0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, //6
+	0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, //7
+	0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, //8
+	0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, //9
+	0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, //A
+	0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, //B
+	0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C, //C
+	0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, //D
+	0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, //E
+	0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0  //F
+};
+
+// Status names for messages
+const char *to_string(const RomStatus &status)
+{
+	switch (status)
+	{
+		case RomStatus::OK: return "ok";
+		case RomStatus::NOT_FOUND: return "file not found";
+		case RomStatus::UNREADABLE: return "file unreadable";
+		case RomStatus::EMPTY: return "file empty";
+		case RomStatus::TOO_LARGE: return "file larger than memory above the program start";
+	}
+	return "unknown";
+}
+
+// Rom bytes sit at the program start
+std::span<const std::byte> RomImage::rom(void) const
+{
+	return std::span(memory).subspan(PROG_START, size);
+}
+
+// FNV-1a over 64 bit words, then the tail bytes and the size. A byte at a time is a multiply chain four times as long
+uint64_t rom_hash(std::span<const std::byte> rom)
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= rom.size(); i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, rom.data() + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001B3ull;
+	}
+	for (; i < rom.size(); ++i)
+		hash = (hash ^ (uint64_t)rom[i]) * 0x100000001B3ull;
+	hash = (hash ^ rom.size()) * 0x100000001B3ull;
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+// Fonts, zero padding, rom, zeros to the end of memory
+std::shared_ptr<const RomImage> make_rom_image(std::span<const std::byte> rom)
+{
+	std::shared_ptr<RomImage> image = std::make_shared<RomImage>();
+	image->size = std::min<size_t>(rom.size(), FlatMemory::SIZE - PROG_START);
+	image->hash = rom_hash(rom.first(image->size));
+	image->platform = detect_platform(rom.first(image->size));
+	image->memory = {};
+
+	std::copy( FONTSET.begin(), FONTSET.end(), (uint8_t*)image->memory.data() + FONT_START );
+	std::copy( BIG_FONTSET.begin(), BIG_FONTSET.end(), (uint8_t*)image->memory.data() + BIG_FONT_START );
+	std::copy( rom.begin(), rom.begin() + image->size, image->memory.begin() + PROG_START );
+
+	return image;
+}
+
+// One copy out of the read buffer
+RomStatus read_rom_file(const std::string &rom_file_path, std::vector<std::byte> &rom)
+{
+	RomFile file;
+	const RomStatus status = file.open(rom_file_path);
+
+	rom.clear();
+	if (status == RomStatus::OK)
+		rom.assign(file.bytes().begin(), file.bytes().end());
+
+	return status;
+}
+
+// Whole memory image. Fonts, zero padding, rom, zeros to the end of memory
+void load_image(FlatMemory &memory, std::span<const std::byte> rom)
+{
+	std::array<std::byte, FlatMemory::SIZE> image = {};
+
+	std::copy( FONTSET.begin(), FONTSET.end(), (uint8_t*)image.data() + FONT_START );
+	std::copy( BIG_FONTSET.begin(), BIG_FONTSET.end(), (uint8_t*)image.data() + BIG_FONT_START );
+	std::copy( rom.begin(), rom.begin() + std::min<size_t>(rom.size(), FlatMemory::SIZE - PROG_START), image.begin() + PROG_START );
+
+	memory.write_block( 0, image );
+}
+
+// Prebuilt image, one block
+void load_image(FlatMemory &memory, const RomImage &image)
+{
+	memory.write_block( 0, image.memory );
+}
+
+// Straight from the read buffer into new memory
+RomStatus load_rom(const std::string &rom_file_path, std::unique_ptr<FlatMemory> &memory)
+{
+	RomFile file;
+	const RomStatus status = file.open(rom_file_path);
+	if (status != RomStatus::OK)
+		return status;
+
+	memory = FlatMemory::makeFlatMemory();
+	load_image( *memory, file.bytes() );
+	return RomStatus::OK;
+}
+
+// Hash the file, build an image only for content not seen before
+RomStatus RomCache::load(const std::string &rom_file_path, std::shared_ptr<const RomImage> &image)
+{
+	RomFile file;
+	const RomStatus status = file.open(rom_file_path);
+	if (status != RomStatus::OK)
+		return status;
+
+	const uint64_t hash = rom_hash(file.bytes());
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto found = m_images.find(hash);
+	if (found != m_images.end())
+	{
+		// A different rom with the same hash gets an image of its own, left out of the cache
+		const std::span<const std::byte> cached = found->second->rom();
+		const bool same = cached.size() == file.bytes().size() && std::memcmp(cached.data(), file.bytes().data(), cached.size()) == 0;
+		image = same ? found->second : make_rom_image(file.bytes());
+		return RomStatus::OK;
+	}
+
+	image = make_rom_image(file.bytes());
+	m_images.emplace(hash, image);
+	return RomStatus::OK;
+}
+
+size_t RomCache::size(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_images.size();
+}
+
+void RomCache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_images.clear();
+}
+
+} // namespace chip8
@@ -0,0 +1,55 @@
+// Project includes
+#include "../include/SaveState.h"	// Function declarations
+#include "../include/Logger.h"		// Logger functionality
+
+// C++ includes
+#include <fstream>	// State files
+
+namespace chip8
+{
+
+// One write of the raw struct
+bool write_state(const std::string &path, const SaveState &state)
+{
+	std::ofstream f_state( path, std::ios::binary | std::ios::trunc );
+
+	if( !f_state.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return false;
+	}
+
+	f_state.write( (const char*)&state, sizeof(SaveState) );
+	return f_state.good();
+}
+
+// One read of the raw struct, then the header checks
+bool read_state(const std::string &path, SaveState &state)
+{
+	std::ifstream f_state( path, std::ios::binary | std::ios::ate );
+
+	if( !f_state.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return false;
+	}
+
+	if( f_state.tellg() != (std::streamoff)sizeof(SaveState) )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not a save state.");
+		return false;
+	}
+
+	f_state.seekg( 0 );
+	f_state.read( (char*)&state, sizeof(SaveState) );
+
+	if( !f_state.good() || state.magic != SaveState::MAGIC || state.version != SaveState::VERSION )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not a version " + std::to_string(SaveState::VERSION) + " save state.");
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace chip8
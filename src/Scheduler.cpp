@@ -0,0 +1,164 @@
+// Project includes
+#include "../include/Scheduler.h"	// Class definition
+
+// C++ includes
+#include <algorithm>	// For min
+#include <thread>		// Portable sleep
+
+#if defined(__linux__)
+#include <errno.h>	// EINTR
+#include <time.h>	// clock_nanosleep
+#endif
+
+namespace	/* Module functions */
+{
+// One frame of virtual time
+constexpr std::chrono::nanoseconds FRAME_PERIOD(1000000000 / chip8::FrameScheduler::FRAME_RATE);
+
+// Sleeps can overshoot by about this much, the rest is spun
+constexpr std::chrono::nanoseconds SPIN_MARGIN = std::chrono::microseconds(500);
+
+// Sleep until an absolute steady clock time
+void sleep_until(const std::chrono::steady_clock::time_point &until)
+{
+#if defined(__linux__)
+	// steady_clock is CLOCK_MONOTONIC on Linux, so its epoch can be handed straight to the kernel
+	const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(until.time_since_epoch()).count();
+	timespec deadline;
+	deadline.tv_sec = since_epoch / 1000000000;
+	deadline.tv_nsec = since_epoch % 1000000000;
+
+	// Absolute deadlines do not drift when a signal interrupts the sleep, just sleep again.
+	// Any other error returns at once, the caller spins out the rest of the frame
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+#else
+	std::this_thread::sleep_until(until);
+#endif
+}
+} // anonymous namespace
+
+namespace chip8
+{
+
+FrameScheduler::FrameScheduler( Interpreter& interpreter, const SchedulerOptions& options ) : m_interpreter(interpreter), m_options(options), m_frames(0), m_late_frames(0)
+{
+	m_deadline = std::chrono::steady_clock::now();
+	m_frame_start = m_previous_start = m_deadline;
+}
+
+// Full frame budget
+Interpreter::RunResult FrameScheduler::run_frame( void )
+{
+	return run_frame(m_options.instructions_per_frame);
+}
+
+// No input changes during the frame
+Interpreter::RunResult FrameScheduler::run_frame( const uint64_t& budget )
+{
+	return run_frame(budget, {});
+}
+
+// Transitions already placed at their cycles
+Interpreter::RunResult FrameScheduler::run_frame( const uint64_t& budget, std::span<const KeyInput> inputs )
+{
+	if (!m_options.deterministic)
+		wait();
+
+	return execute(budget, inputs);
+}
+
+// Place queued transitions at the cycles matching their host time
+Interpreter::RunResult FrameScheduler::run_frame( InputQueue& queue )
+{
+	if (!m_options.deterministic)
+		wait();
+
+	const uint64_t budget = m_options.instructions_per_frame;
+	const auto window = m_frame_start - m_previous_start;
+	m_inputs.clear();
+
+	while (const KeyTransition *transition = queue.front())
+	{
+		uint32_t cycle = 0;
+
+		if (!m_options.deterministic)
+		{
+			// Happened after this frame started, it belongs to the next one
+			if (transition->time >= m_frame_start)
+				break;
+
+			// Scale the offset into the previous frame to the budget. Anything older lands at cycle 0
+			const auto offset = transition->time - m_previous_start;
+			if (offset.count() > 0 && window.count() > 0)
+				cycle = (uint32_t)std::min<uint64_t>(budget - 1, budget * offset.count() / window.count());
+		}
+
+		m_inputs.push_back({cycle, transition->key, transition->pressed});
+		queue.pop();
+	}
+
+	return execute(budget, m_inputs);
+}
+
+// Keep the schedule without touching the interpreter
+void FrameScheduler::skip_frame( void )
+{
+	if (!m_options.deterministic)
+		wait();
+}
+
+// Instructions first, then the once per frame timer tick
+Interpreter::RunResult FrameScheduler::execute( const uint64_t& budget, std::span<const KeyInput> inputs )
+{
+	Interpreter::RunResult result = Interpreter::RunResult::CYCLES;
+	uint64_t done = 0;
+
+	for (const KeyInput &input : inputs)
+	{
+		const uint64_t at = std::min<uint64_t>(input.cycle, budget);
+
+		// Run up to the transition. A key wait idles until it, since only a transition can end the wait
+		if (at > done && result != Interpreter::RunResult::EXIT)
+		{
+			result = m_interpreter.run_cycles(at - done);
+			done = at;
+		}
+
+		const uint16_t bit = 1u << (input.key & 0xF);
+		m_interpreter.set_key_mask(input.pressed ? m_interpreter.key_mask() | bit : m_interpreter.key_mask() & ~bit);
+	}
+
+	if (budget > done && result != Interpreter::RunResult::EXIT)
+		result = m_interpreter.run_cycles(budget - done);
+
+	m_interpreter.tick_timers();
+	++m_frames;
+
+	return result;
+}
+
+// Hybrid wait, the kernel sleep gets close and spinning lands on the deadline
+void FrameScheduler::wait( void )
+{
+	auto now = std::chrono::steady_clock::now();
+
+	// Far behind, e.g. after the window was dragged. Restart the schedule instead of running a burst of frames
+	if (now > m_deadline + FRAME_PERIOD)
+	{
+		++m_late_frames;
+		m_deadline = now;
+	}
+
+	if (m_deadline - now > SPIN_MARGIN)
+		sleep_until(m_deadline - SPIN_MARGIN);
+
+	while (std::chrono::steady_clock::now() < m_deadline) {}
+
+	m_previous_start = m_frame_start;
+	m_frame_start = m_deadline;
+
+	// Next deadline in virtual time, independent of when this frame really started
+	m_deadline += FRAME_PERIOD;
+}
+
+} // namespace chip8
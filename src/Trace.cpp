@@ -0,0 +1,174 @@
+// Project includes
+#include "../include/Trace.h"	// Class definition
+#include "../include/Logger.h"	// Logger functionality
+
+// C++ includes
+#include <algorithm>	// For max
+#include <bit>			// bit_ceil
+#include <cstring>		// memcpy
+#include <fstream>		// Reading trace files
+
+#if defined(__unix__)
+#include <fcntl.h>		// open
+#include <sys/mman.h>	// mmap
+#include <unistd.h>		// ftruncate, close
+#endif
+
+namespace chip8
+{
+
+TraceRing::TraceRing( void ) : m_header(nullptr), m_records(nullptr), m_mapping(nullptr), m_mapped_bytes(0), m_written(0), m_mask(0), m_sample(1), m_countdown(1)
+{
+}
+
+TraceRing::~TraceRing( void )
+{
+#if defined(__unix__)
+	if (m_mapping)
+		munmap(m_mapping, m_mapped_bytes);
+#endif
+}
+
+// Header first, the records follow it
+void TraceRing::init( const uint32_t& capacity, const uint32_t& sample )
+{
+	std::memcpy(m_header->magic, TraceHeader::MAGIC, sizeof(m_header->magic));
+	m_header->version = TraceHeader::VERSION;
+	m_header->capacity = capacity;
+	m_header->sample = sample;
+	m_header->written = 0;
+
+	m_records = reinterpret_cast<TraceRecord *>(m_header + 1);
+	m_written = 0;
+	m_mask = capacity - 1;
+	m_sample = sample;
+	m_countdown = 1;
+}
+
+// Factory method
+// Uses local struct to dodge private constructor issue for static method
+std::unique_ptr<TraceRing> TraceRing::make_trace_ring( const uint32_t& capacity, const uint32_t& sample )
+{
+	struct MakeUniquePublic : public TraceRing {
+		MakeUniquePublic( void ) : TraceRing() {}
+	};
+
+	const uint32_t records = std::bit_ceil(std::max(capacity, 1u));
+	std::unique_ptr<TraceRing> ring = std::make_unique<MakeUniquePublic>();
+
+	ring->m_storage = std::make_unique<uint8_t[]>(sizeof(TraceHeader) + (size_t)records * sizeof(TraceRecord));
+	ring->m_header = reinterpret_cast<TraceHeader *>(ring->m_storage.get());
+	ring->init(records, std::max(sample, 1u));
+
+	return ring;
+}
+
+// Shared file mapping, every record lands in the page cache as it is written
+std::unique_ptr<TraceRing> TraceRing::map_trace_file( const std::string& path, const uint32_t& capacity, const uint32_t& sample )
+{
+#if defined(__unix__)
+	struct MakeUniquePublic : public TraceRing {
+		MakeUniquePublic( void ) : TraceRing() {}
+	};
+
+	const uint32_t records = std::bit_ceil(std::max(capacity, 1u));
+	const size_t bytes = sizeof(TraceHeader) + (size_t)records * sizeof(TraceRecord);
+
+	const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return nullptr;
+	}
+
+	void *mapping = MAP_FAILED;
+	if (ftruncate(fd, (off_t)bytes) == 0)
+		mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to map.");
+		return nullptr;
+	}
+
+	std::unique_ptr<TraceRing> ring = std::make_unique<MakeUniquePublic>();
+	ring->m_mapping = mapping;
+	ring->m_mapped_bytes = bytes;
+	ring->m_header = static_cast<TraceHeader *>(mapping);
+	ring->init(records, std::max(sample, 1u));
+
+	return ring;
+#else
+	util::LOG(LOGTYPE::ERROR, "File: " + path + " can not be mapped on this platform.");
+	return nullptr;
+#endif
+}
+
+// Oldest record sits right after the newest once the ring wrapped
+std::vector<TraceRecord> TraceRing::records( void ) const
+{
+	const uint64_t written = m_header->written;
+	const uint64_t held = std::min<uint64_t>(written, m_header->capacity);
+
+	std::vector<TraceRecord> ordered;
+	ordered.reserve(held);
+	for (uint64_t i = written - held; i < written; ++i)
+		ordered.push_back(m_records[i & (m_header->capacity - 1)]);
+
+	return ordered;
+}
+
+// Header checks, then the ring unrolled oldest first
+bool read_trace( const std::string& path, TraceHeader& header, std::vector<TraceRecord>& records )
+{
+	std::ifstream f_trace( path, std::ios::binary );
+
+	if( !f_trace.is_open() )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " failed to open.");
+		return false;
+	}
+
+	f_trace.read( (char*)&header, sizeof(TraceHeader) );
+	if( !f_trace || std::memcmp(header.magic, TraceHeader::MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != TraceHeader::VERSION || header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0 )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is not a trace.");
+		return false;
+	}
+
+	std::vector<TraceRecord> ring(header.capacity);
+	f_trace.read( (char*)ring.data(), (std::streamsize)(ring.size() * sizeof(TraceRecord)) );
+	if( !f_trace )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + path + " is truncated.");
+		return false;
+	}
+
+	const uint64_t held = std::min<uint64_t>(header.written, header.capacity);
+	records.clear();
+	records.reserve(held);
+	for (uint64_t i = header.written - held; i < header.written; ++i)
+		records.push_back(ring[i & (header.capacity - 1)]);
+
+	return true;
+}
+
+// 6xnn, 7xnn, the 8xy_ arithmetic, Cxnn, Fx07, Fx0A and Fx65
+bool writes_vx( const uint16_t& opcode )
+{
+	switch (opcode >> 12)
+	{
+		case 0x6: case 0x7: case 0xC: return true;
+		case 0x8: return (opcode & 0xF) <= 0x7 || (opcode & 0xF) == 0xE;
+		case 0xF:
+		{
+			const uint8_t nn = opcode & 0xFF;
+			return nn == 0x07 || nn == 0x0A || nn == 0x65;
+		}
+		default: return false;
+	}
+}
+
+} // namespace chip8
@@ -5,127 +5,247 @@
 #include <algorithm>
 #include <string>
 
+#include <cstdlib>
+#include <atomic>
 #include <chrono>
 #include <thread>
+#include <random>
 
 #include "SDL2/SDL.h"
 
 #include "../include/Interpreter.h"
 #include "../include/Memory.h"
+#include "../include/Movie.h"
 #include "../include/Graphics.h"
 #include "../include/Logger.h"
+#include "../include/Rewind.h"
+#include "../include/Rom.h"
+#include "../include/Scheduler.h"
+#include "../include/TripleBuffer.h"
 
-// Used for loading the rom
-std::unique_ptr<chip8::MemoryMap> load_rom(std::string rom_file_path);
+namespace
+{
+// Screen as published by the emulation thread
+struct Frame
+{
+	chip8::ScreenRows rows;
+	uint64_t generation;
+	uint8_t width, height;
+};
+} // anonymous namespace
 
 int main(int argc, char **argv){
 	std::string file_path = "";
-
-	// Process input arguments. No checks right now for proper file
-	if( argc == 2 )
+	chip8::SchedulerOptions options;
+	uint64_t seed = std::random_device()();
+	unsigned long rewind_seconds = 30;
+	std::string record_path = "";
+	bool profile = false;
+	std::string trace_path = "";
+	std::string quirks_name = "";
+
+	// Process input arguments. <rom> [--ipf N] [--deterministic] [--seed N] [--rewind SECONDS] [--record FILE] [--profile] [--trace FILE] [--quirks SET]
+	for( int i = 1; i < argc; ++i )
 	{
-		file_path = (argv[1]);
-		util::LOG(LOGTYPE::DEBUG, "ROM: " + file_path + " selected.");
-		util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+		std::string arg = argv[i];
+
+		if( arg == "--ipf" && i + 1 < argc )
+			options.instructions_per_frame = std::strtoul(argv[++i], nullptr, 10);
+		else if( arg == "--deterministic" )
+			options.deterministic = true;
+		else if( arg == "--seed" && i + 1 < argc )
+			seed = std::strtoull(argv[++i], nullptr, 0);
+		else if( arg == "--rewind" && i + 1 < argc )
+			rewind_seconds = std::strtoul(argv[++i], nullptr, 10);
+		else if( arg == "--record" && i + 1 < argc )
+			record_path = argv[++i];
+		else if( arg == "--profile" )
+			profile = true;
+		else if( arg == "--trace" && i + 1 < argc )
+			trace_path = argv[++i];
+		else if( arg == "--quirks" && i + 1 < argc )
+			quirks_name = argv[++i];
+		else if( file_path.empty() && arg.rfind("--", 0) != 0 )
+			file_path = arg;
+		else
+		{
+			util::LOG(LOGTYPE::ERROR, "Invalid CL arguments supplied. Quitting.");
+			exit(1);
+		}
 	}
-	else
+
+	if( file_path.empty() || options.instructions_per_frame == 0 )
 	{
 		util::LOG(LOGTYPE::ERROR, "Invalid CL arguments supplied. Quitting.");
 		exit(1);
 	}
 
+	util::LOG(LOGTYPE::DEBUG, "ROM: " + file_path + " selected.");
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+
 	// Initialize memory map
-	std::unique_ptr<chip8::MemoryMap> memory_map = std::move(load_rom(file_path));
+	std::unique_ptr<chip8::FlatMemory> memory_map;
+	const chip8::RomStatus rom_status = chip8::load_rom(file_path, memory_map);
+	if( rom_status != chip8::RomStatus::OK )
+	{
+		util::LOG(LOGTYPE::ERROR, "File: " + file_path + " " + chip8::to_string(rom_status) + ". Quitting.");
+		util::Logger::get_instance()->flush();
+		exit(1);
+	}
+
+	// Quirks the rom's platform expects unless named
+	uint8_t quirks = chip8::platform_profile(chip8::detect_platform(memory_map->data().subspan(chip8::PROG_START))).quirks;
+	if( !quirks_name.empty() && !chip8::parse_quirks(quirks_name, quirks) )
+	{
+		util::LOG(LOGTYPE::ERROR, "Unknown quirk set " + quirks_name + ". Quitting.");
+		util::Logger::get_instance()->flush();
+		exit(1);
+	}
 
 	// Initialize interpreter
 	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory_map));
+	interpreter->seed(seed);
+	interpreter->set_quirks(quirks);
+	interpreter->enable_profiling(profile);
 
-	// Initialize SDL2 graphics
-	chip8::Graphics::instance().init();
-
-	// Game loop.
-	for(;;)
+	// The last instructions stay in the file if the emulator crashes
+	if( !trace_path.empty() )
 	{
-		// Proceed to next interpreter instruction
-		interpreter->next_instruction();
-
-		// Process key events
-		interpreter->sync_keys( chip8::Graphics::instance().check_events() );
-
-		// Update screen if required
-		if( interpreter->draw() == true )
-		{
-			chip8::Graphics::instance().update_texture( interpreter->screen() );
-		}
-
-		// Delay for random time. Ideally use delay timer instead
-		std::this_thread::sleep_for(std::chrono::microseconds(3600));
+		std::unique_ptr<chip8::TraceRing> ring = chip8::TraceRing::map_trace_file(trace_path, 1 << 16);
+		if( !ring )
+			exit(1);
+		interpreter->set_trace(std::move(ring));
 	}
 
-	return 0;
-}
-
-// Chip8 fontset loaded into each rom at the start
-const std::array<uint8_t, 80> FONTSET = 
-{
-	0xF0, 0x90, 0x90, 0x90, 0xF0, //0
-	0x20, 0x60, 0x20, 0x20, 0x70, //1
-	0xF0, 0x10, 0xF0, 0x80, 0xF0, //2
-	0xF0, 0x10, 0xF0, 0x10, 0xF0, //3
-	0x90, 0x90, 0xF0, 0x10, 0x10, //4
-	0xF0, 0x80, 0xF0, 0x10, 0xF0, //5
-	0xF0, 0x80, 0xF0, 0x90, 0xF0, //6
-	0xF0, 0x10, 0x20, 0x40, 0x40, //7
-	0xF0, 0x90, 0xF0, 0x90, 0xF0, //8
-	0xF0, 0x90, 0xF0, 0x10, 0xF0, //9
-	0xF0, 0x90, 0xF0, 0x90, 0x90, //A
-	0xE0, 0x90, 0xE0, 0x90, 0xE0, //B
-	0xF0, 0x80, 0x80, 0x80, 0xF0, //C
-	0xE0, 0x90, 0x90, 0x90, 0xE0, //D
-	0xF0, 0x80, 0xF0, 0x80, 0xF0, //E
-	0xF0, 0x80, 0xF0, 0x80, 0x80  //F
-};
+	// A movie needs every frame in order, so recording turns rewind off
+	chip8::Movie movie;
+	movie.seed = seed;
+	movie.instructions_per_frame = options.instructions_per_frame;
+	movie.quirks = quirks;
+	movie.start_hash = chip8::state_hash(*interpreter);
+	if( !record_path.empty() )
+		rewind_seconds = 0;
 
+	// Initialize SDL2 graphics. This thread owns every SDL object and becomes the render thread
+	chip8::Graphics::instance().init();
 
-// Load data from file into memory map
-std::unique_ptr<chip8::MemoryMap> load_rom(std::string rom_file_path)
-{	
-	std::unique_ptr<chip8::MemoryMap> memory_map = chip8::MemoryMap::makeMemoryMap(4096);
-
-	// Load rom into memory map starting at 0
-	unsigned int mem_adr = chip8::FONT_START;
+	// Finished frames go from the emulation thread to this one and key transitions the other way, without either side waiting
+	chip8::TripleBuffer<Frame> frames;
+	chip8::InputQueue inputs;
+	std::atomic<bool> running = true, rewinding = false, report = false;
 
-	// Chip8 environment variables are static constants in Chip8Interpreter
-	for(auto &font_byte : FONTSET)
+	// Emulation thread. 60 Hz frames, each runs the instruction budget then ticks the timers
+	std::thread emulation([&]()
 	{
-		memory_map->store( (std::byte) font_byte, mem_adr++);
-	}
+		chip8::FrameScheduler scheduler(*interpreter, options);
+		chip8::RewindBuffer history(rewind_seconds * chip8::FrameScheduler::FRAME_RATE);
+		chip8::SaveState state;
+		uint64_t published_generation = ~0ull;
 
-	// Lazy way of padding extra memory in map with default value 0
-	while(mem_adr < chip8::PROG_START)
-	{
-		memory_map->store( (std::byte) 0, mem_adr++);
-	}
+		while( running.load(std::memory_order_relaxed) )
+		{
+			// Counts stay on the emulation thread, so it writes the report between frames
+			if( report.exchange(false, std::memory_order_relaxed) )
+				interpreter->write_profile(std::cerr);
+
+			if( rewinding.load(std::memory_order_relaxed) )
+			{
+				// Step back one frame per frame. Keys keep their current state, queued transitions wait for play to resume
+				scheduler.skip_frame();
+				if( history.pop(state) )
+				{
+					const uint16_t keys = interpreter->key_mask();
+					interpreter->load_state(state);
+					interpreter->set_key_mask(keys);
+				}
+			}
+			else if( !record_path.empty() )
+			{
+				// Movies hold one key mask per frame, so every transition queued so far applies from the frame's first instruction
+				uint16_t keys = interpreter->key_mask();
+				while( const chip8::KeyTransition *transition = inputs.front() )
+				{
+					keys = transition->pressed ? keys | (1u << transition->key) : keys & ~(1u << transition->key);
+					inputs.pop();
+				}
+				interpreter->set_key_mask(keys);
+
+				if( scheduler.run_frame() == chip8::Interpreter::RunResult::EXIT )
+					running = false;
+
+				movie.keys.push_back(keys);
+				movie.hashes.push_back(chip8::state_hash(*interpreter));
+			}
+			else
+			{
+				// Run one frame, waiting for its deadline first. Key transitions land at the cycle they happened at
+				if( scheduler.run_frame(inputs) == chip8::Interpreter::RunResult::EXIT )
+					running = false;
+
+				if( rewind_seconds > 0 && interpreter->save_state(state) )
+					history.push(state);
+			}
+
+			// Publish once per frame, however many draws happened in it
+			const chip8::Interpreter::FrameView view = interpreter->frame();
+			if( view.generation != published_generation )
+			{
+				frames.back() = { view.rows, view.generation, view.width, view.height };
+				frames.publish();
+				published_generation = view.generation;
+			}
+		}
+	});
 
-	// Open rom file
-	std::ifstream f_rom( rom_file_path );
-	mem_adr = chip8::PROG_START;
-	
-	// Store every byte in the rom into the memory map
-	if( f_rom.is_open() )
-	{
-		unsigned char rom_byte = f_rom.get();
+	// Render loop. Pumps input once per display frame and shows the latest complete frame, skipping any the display was too slow for
+	chip8::ScreenRows shown = {};
+	uint8_t shown_width = 0, shown_height = 0;
+	uint64_t dirty = ~0ull;
+	auto next_pump = std::chrono::steady_clock::now();
 
-		while( f_rom.good() )
+	while( running.load(std::memory_order_relaxed) )
+	{
+		if( chip8::Graphics::instance().pump_events(inputs) )
+			running = false;
+		rewinding.store(chip8::Graphics::instance().rewinding(), std::memory_order_relaxed);
+		if( chip8::Graphics::instance().take_profile_request() && profile )
+			report.store(true, std::memory_order_relaxed);
+
+		// Nothing new to show. Vsync does not pace this iteration, so sleep to the next display frame instead
+		if( !frames.update() )
 		{
-			memory_map->store( (std::byte) rom_byte, mem_adr++);
-			rom_byte = f_rom.get();
+			next_pump += std::chrono::nanoseconds(1000000000 / chip8::FrameScheduler::FRAME_RATE);
+			const auto now = std::chrono::steady_clock::now();
+			if( next_pump < now )
+				next_pump = now;
+			std::this_thread::sleep_until(next_pump);
+			continue;
 		}
+
+		// Frames may have been skipped, so diff against what is on screen instead of trusting one frame's dirty rows.
+		// A resolution change redraws everything
+		const Frame &frame = frames.front();
+		if( frame.width != shown_width || frame.height != shown_height )
+			dirty = ~0ull;
+		for( unsigned int y = 0; y < frame.height; ++y )
+			if( frame.rows[y] != shown[y] )
+				dirty |= uint64_t(1) << y;
+
+		// Waits for vsync
+		chip8::Graphics::instance().present( { frame.rows, frame.generation, dirty, frame.width, frame.height } );
+		shown = frame.rows;
+		shown_width = frame.width;
+		shown_height = frame.height;
+		dirty = 0;
+		next_pump = std::chrono::steady_clock::now();
 	}
-	else
-	{
-		util::LOG(LOGTYPE::ERROR, "File: " + rom_file_path + " failed to open.");
-	}
 
-	return memory_map;
+	emulation.join();
+
+	if( profile )
+		interpreter->write_profile(std::cerr);
+
+	if( !record_path.empty() && !chip8::write_movie(record_path, movie) )
+		return 1;
+	return 0;
 }
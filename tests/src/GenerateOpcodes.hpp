@@ -327,9 +327,80 @@ namespace chip8
 		 *
 		 * @param[in]  reg   Register x. Must be 1 byte value
 		 *
-		 * @return     Correct opcode for storing registers [V0, Vx] in memory starting at I
+		 * @return     Correct opcode for reading registers [V0, Vx] from memory starting at I
+		 */
+		inline unsigned int read_regs_mem_call(const unsigned int& reg){ return 0xF065  | (reg<<8); }
+
+		/**
+		 * @brief      Generate opcode for scrolling the screen down n rows 00Cn
+		 *
+		 * @param[in]  n     Rows to scroll. Must be max 0xF
+		 *
+		 * @return     Correct opcode for scroll down
+		 */
+		inline unsigned int scroll_down_call(const unsigned int& n){ return 0x00C0 | n; }
+
+		/**
+		 * @brief      Generate opcode for scrolling the screen right 4 pixels 0x00FB
+		 *
+		 * @return     Correct opcode for scroll right
+		 */
+		inline unsigned int scroll_right_call( void ){ return 0x00FB; }
+
+		/**
+		 * @brief      Generate opcode for scrolling the screen left 4 pixels 0x00FC
+		 *
+		 * @return     Correct opcode for scroll left
+		 */
+		inline unsigned int scroll_left_call( void ){ return 0x00FC; }
+
+		/**
+		 * @brief      Generate opcode for exiting the interpreter 0x00FD
+		 *
+		 * @return     Correct opcode for exit
+		 */
+		inline unsigned int exit_call( void ){ return 0x00FD; }
+
+		/**
+		 * @brief      Generate opcode for switching to low resolution 0x00FE
+		 *
+		 * @return     Correct opcode for low resolution
+		 */
+		inline unsigned int lores_call( void ){ return 0x00FE; }
+
+		/**
+		 * @brief      Generate opcode for switching to high resolution 0x00FF
+		 *
+		 * @return     Correct opcode for high resolution
+		 */
+		inline unsigned int hires_call( void ){ return 0x00FF; }
+
+		/**
+		 * @brief      Generate opcode for setting I to the big font sprite for digit Vx
+		 *
+		 * @param[in]  reg   Register x. Must be 1 byte value
+		 *
+		 * @return     Correct opcode for big font sprite location
+		 */
+		inline unsigned int index_big_sprite_call(const unsigned int& reg){ return 0xF030  | (reg<<8); }
+
+		/**
+		 * @brief      Generate opcode for storing registers [V0, Vx] in the RPL user flags
+		 *
+		 * @param[in]  reg   Register x. Must be 1 byte value
+		 *
+		 * @return     Correct opcode for storing registers in RPL flags
+		 */
+		inline unsigned int store_rpl_call(const unsigned int& reg){ return 0xF075  | (reg<<8); }
+
+		/**
+		 * @brief      Generate opcode for reading registers [V0, Vx] from the RPL user flags
+		 *
+		 * @param[in]  reg   Register x. Must be 1 byte value
+		 *
+		 * @return     Correct opcode for reading registers from RPL flags
 		 */
-		inline unsigned int read_regs_mem_call(const unsigned int& reg){ return 0xF055  | (reg<<8); }
+		inline unsigned int read_rpl_call(const unsigned int& reg){ return 0xF085  | (reg<<8); }
 
 
 
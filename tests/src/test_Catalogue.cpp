@@ -0,0 +1,129 @@
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+// Platform of a rom given as opcodes
+chip8::Platform platform_of(const std::vector<uint16_t> &opcodes)
+{
+    std::vector<std::byte> rom;
+    for (const uint16_t &opcode : opcodes)
+    {
+        rom.push_back(std::byte(opcode >> 8));
+        rom.push_back(std::byte(opcode & 0xFF));
+    }
+    return chip8::detect_platform(rom);
+}
+
+// Write a file with text or bytes under a directory
+void write_file(const std::filesystem::path &path, const std::string &contents)
+{
+    std::ofstream f_out(path, std::ios::binary | std::ios::trunc);
+    f_out << contents;
+}
+} // anonymous namespace
+
+// Function to test that only reachable instructions decide the platform
+TEST(CatalogueTest, platform_test)
+{
+    ASSERT_EQ(chip8::Platform::CHIP8, platform_of({ 0x6005, 0x1202 }));
+    ASSERT_EQ(chip8::Platform::SCHIP, platform_of({ 0x00FF, 0x1202 }));
+    ASSERT_EQ(chip8::Platform::XOCHIP, platform_of({ 0xF000, 0x0300, 0x1204 }));
+
+    // Data after an endless jump is never read as code
+    ASSERT_EQ(chip8::Platform::CHIP8, platform_of({ 0x1200, 0x00FF, 0xF002 }));
+
+    // Subroutines and both sides of a skip are followed
+    ASSERT_EQ(chip8::Platform::SCHIP, platform_of({ 0x2206, 0x1202, 0x00FF, 0x00FE, 0x00EE }));
+    ASSERT_EQ(chip8::Platform::SCHIP, platform_of({ 0x3000, 0x1200, 0xD120, 0x1204 }));
+
+    // Two page roms start at 0x2C0 past their patched interpreter
+    std::vector<uint16_t> hires(0x60, 0x00FF);
+    hires[0] = 0x1260;
+    hires.push_back(0x00E0);
+    hires.push_back(0x12C2);
+    ASSERT_EQ(chip8::Platform::CHIP8_HIRES, platform_of(hires));
+
+    ASSERT_EQ(chip8::QUIRK_JUMP_VX | chip8::QUIRK_CLIP, chip8::platform_profile(chip8::Platform::SCHIP).quirks);
+    ASSERT_EQ(10u, chip8::platform_profile(chip8::Platform::CHIP8).instructions_per_frame);
+}
+
+// Function to test that a scan groups copies, reads sidecars and survives the round trip through an index file
+TEST(CatalogueTest, index_test)
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "chip8_catalogue";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "games");
+    std::filesystem::create_directories(root / "full_games");
+
+    const std::string pong("\x60\x05\x12\x00", 4);
+    write_file(root / "games" / "Pong [Paul Vervalin, 1990].ch8", pong);
+    write_file(root / "games" / "Pong [Paul Vervalin, 1990] (alt).ch8", pong + pong);
+    write_file(root / "games" / "Pong [Paul Vervalin, 1990].txt", "Title\t\t:\tPong\r\nSystem : Chip8\r\n\r\nMove with 1 and 4\r\n");
+    write_file(root / "full_games" / "PONG", pong);
+    write_file(root / "full_games" / "EMPTY", "");
+
+    std::vector<chip8::CatalogueRecord> records;
+    ASSERT_TRUE(chip8::scan_corpus(root.string(), records));
+    ASSERT_EQ(3u, records.size());
+
+    ASSERT_EQ("full_games/PONG", records[0].path);
+    ASSERT_EQ("games/Pong [Paul Vervalin, 1990] (alt).ch8", records[1].path);
+    ASSERT_EQ(records[0].hash, records[2].hash);
+    ASSERT_EQ(records[0].group, records[2].group);
+    ASSERT_NE(records[0].group, records[1].group);
+
+    ASSERT_EQ("PONG", records[0].title);
+    ASSERT_EQ("Pong", records[2].title);
+    ASSERT_EQ("Paul Vervalin", records[2].author);
+    ASSERT_EQ("1990", records[2].date);
+    ASSERT_EQ("Chip8", records[2].system);
+    ASSERT_EQ("Title\t\t:\tPong\nSystem : Chip8\n\nMove with 1 and 4", records[2].notes);
+
+    // The variant shares the sidecar
+    ASSERT_EQ(records[2].notes, records[1].notes);
+
+    const std::string index = (root / "roms.c8i").string();
+    ASSERT_TRUE(chip8::write_catalogue(index, root.string(), records));
+
+    std::unique_ptr<chip8::Catalogue> catalogue = chip8::Catalogue::open_catalogue(index);
+    ASSERT_NE(nullptr, catalogue);
+    ASSERT_EQ(3u, catalogue->size());
+    ASSERT_EQ(2u, catalogue->groups());
+    ASSERT_EQ(root.string(), catalogue->root());
+
+    const chip8::CatalogueEntry *entry = catalogue->find(std::string_view("games/Pong [Paul Vervalin, 1990].ch8"));
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(4u, entry->size);
+    ASSERT_EQ(chip8::Platform::CHIP8, entry->platform);
+    ASSERT_EQ("Pong", catalogue->text(entry->title));
+    ASSERT_EQ(records[2].notes, catalogue->text(entry->notes));
+    ASSERT_EQ(nullptr, catalogue->find(std::string_view("games/Tetris.ch8")));
+
+    // Copies resolve to the first path
+    ASSERT_EQ(&(*catalogue)[0], catalogue->find(records[2].hash));
+    ASSERT_EQ(nullptr, catalogue->find(records[2].hash + 1));
+
+    ASSERT_FALSE(catalogue->stale(*entry));
+    write_file(root / "games" / "Pong [Paul Vervalin, 1990].ch8", pong + pong + pong);
+    ASSERT_TRUE(catalogue->stale(*entry));
+
+    // An entry number past the entries in the hash table is refused
+    catalogue.reset();
+    std::string bytes;
+    {
+        std::ifstream f_index(index, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(f_index), std::istreambuf_iterator<char>());
+    }
+    const uint32_t past_end = 3;
+    std::memcpy(bytes.data() + sizeof(chip8::CatalogueHeader) + 3 * sizeof(chip8::CatalogueEntry) + sizeof(uint32_t), &past_end, sizeof(past_end));
+    write_file(index, bytes);
+    ASSERT_EQ(nullptr, chip8::Catalogue::open_catalogue(index));
+
+    // Anything else is refused
+    write_file(index, "C8CI but no index");
+    ASSERT_EQ(nullptr, chip8::Catalogue::open_catalogue(index));
+    ASSERT_EQ(nullptr, chip8::Catalogue::open_catalogue(index + ".missing"));
+
+    std::filesystem::remove_all(root);
+}
@@ -2,9 +2,18 @@
 
 #include "../../include/Interpreter.h"
 #include "../../src/Interpreter.cpp"
+#include "../../src/Recompiler.cpp"
+#include "../../src/SaveState.cpp"
+#include "../../src/Movie.cpp"
+#include "../../src/Profiler.cpp"
+#include "../../src/Trace.cpp"
 #include "../../src/Logger.cpp"
+#include "../../src/Platform.cpp"
+#include "../../src/Catalogue.cpp"
 #include "GenerateOpcodes.hpp"
 
+#include <sstream>
+
 
 class MockMemory: public chip8::MemoryMap
 {
@@ -35,6 +44,18 @@ protected:
     std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::make_unique<MockMemory>());
 };
 
+class Chip8FlatCPU : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Disable logging for tests
+        util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE); 
+    }
+
+    std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(chip8::FlatMemory::makeFlatMemory());
+};
+
 // Function to test clear screen opcode
 // 1. Set screen to non-zero state then call clear screen opcode. Pixel array should be all 0s
 TEST_F(Chip8CPU, ClearScreenTest)
@@ -45,7 +66,8 @@ TEST_F(Chip8CPU, ClearScreenTest)
     interpreter->execute(clear_scr_call());
 
     // Check pixel array
-    std::array< unsigned int, 64 * 32> pixels = interpreter->screen();
+    std::vector<uint32_t> pixels = interpreter->screen();
+    ASSERT_EQ(64u * 32u, pixels.size());
     for (auto & pixel : pixels)  
     {
         ASSERT_EQ( 0 , pixel ) << "There exists a non-false pixel in the array";
@@ -487,7 +509,6 @@ TEST_F(Chip8CPU, jump_ir_test)
 }
 
 // Function to test random setting of vx AND kk Cxkk
-// TODO: How do I test this better
 TEST_F(Chip8CPU, rand_vx_test)
 {
     // For opcode generators
@@ -495,11 +516,41 @@ TEST_F(Chip8CPU, rand_vx_test)
 
     unsigned int vx = 6;
 
-    interpreter->execute(rand_reg_call(vx, 100));
+    // Masked bits stay clear
+    std::array<uint8_t, 64> first;
+    for (uint8_t &value : first)
+    {
+        interpreter->execute(rand_reg_call(vx, 0x5A));
+        value = interpreter->m_registers[vx];
+        ASSERT_EQ(0, value & ~0x5A);
+    }
+
+    // Not stuck on one value
+    ASSERT_NE(std::count(first.begin(), first.end(), first[0]), (long)first.size());
 
-    unsigned int a = interpreter->m_registers[vx];
+    // Reset replays the sequence of the seed
+    interpreter->reset();
+    for (const uint8_t &value : first)
+    {
+        interpreter->execute(rand_reg_call(vx, 0x5A));
+        ASSERT_EQ(value, interpreter->m_registers[vx]);
+    }
 
-    ASSERT_TRUE((a >= 0) && (a <= 255));
+    // A different seed gives a different sequence, the same seed the same one
+    std::array<uint8_t, 64> other;
+    interpreter->seed(42);
+    for (uint8_t &value : other)
+    {
+        interpreter->execute(rand_reg_call(vx, 0xFF));
+        value = interpreter->m_registers[vx];
+    }
+    interpreter->seed(42);
+    for (const uint8_t &value : other)
+    {
+        interpreter->execute(rand_reg_call(vx, 0xFF));
+        ASSERT_EQ(value, interpreter->m_registers[vx]);
+    }
+    ASSERT_EQ(42u, interpreter->seed());
 }
 
 // Function to test sound and delay timer opcodes Fx07, Fx15, Fx18
@@ -549,5 +600,383 @@ TEST_F(Chip8CPU, add_ir_vx_test)
     ASSERT_EQ(interpreter->m_index_register, org_ir+100);
 }
 
-// TODO: Skipped D and E opcode tests
-// TODO: Skipped Fx0A, Fx29, Fx33, Fx55, Fx65
\ No newline at end of file
+// TODO: Skipped E opcode tests
+// TODO: Skipped Fx0A, Fx29
+
+// Function to test BCD store Fx33 through flat memory
+TEST_F(Chip8FlatCPU, store_bcd_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    unsigned int vx = 3;
+    interpreter->execute(set_reg_call(vx, 254));
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(store_bcd_call(vx));
+
+    ASSERT_EQ(std::byte(2), interpreter->m_ram->fetch(0x300));
+    ASSERT_EQ(std::byte(5), interpreter->m_ram->fetch(0x301));
+    ASSERT_EQ(std::byte(4), interpreter->m_ram->fetch(0x302));
+}
+
+// Function to test register store Fx55 and read Fx65 round trip through flat memory
+TEST_F(Chip8FlatCPU, store_read_regs_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    for (unsigned int vx = 0; vx < 16; ++vx)
+        interpreter->execute(set_reg_call(vx, vx + 1));
+
+    // Store V0 to V7, clear them, then read them back
+    interpreter->execute(set_i_call(0x400));
+    interpreter->execute(store_regs_mem_call(7));
+    ASSERT_EQ(std::byte(8), interpreter->m_ram->fetch(0x407));
+    ASSERT_EQ(std::byte(0), interpreter->m_ram->fetch(0x408));
+
+    for (unsigned int vx = 0; vx < 16; ++vx)
+        interpreter->execute(set_reg_call(vx, 0));
+
+    interpreter->execute(read_regs_mem_call(7));
+    for (unsigned int vx = 0; vx < 8; ++vx)
+        ASSERT_EQ(vx + 1, interpreter->m_registers[vx]);
+    ASSERT_EQ(0, interpreter->m_registers[8]);
+}
+
+// Function to test that a predecoded instruction is dropped once Fx55 stores over it
+TEST_F(Chip8FlatCPU, self_modifying_code_test)
+{
+    const std::array<uint8_t, 10> program = {
+        0x60, 0x62,     // 200: V0 = 0x62
+        0x61, 0x09,     // 202: V1 = 0x09
+        0xA2, 0x08,     // 204: I = 0x208
+        0xF1, 0x55,     // 206: Store V0, V1 at 0x208, turning 208 into V2 = 9
+        0x62, 0x01      // 208: V2 = 1
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    // Run 208 first so it is predecoded as V2 = 1
+    interpreter->m_program_counter = 0x208;
+    interpreter->next_instruction();
+    ASSERT_EQ(1, interpreter->m_registers[2]);
+
+    // Run the whole program, 208 must be decoded again after the store
+    interpreter->m_program_counter = 0x200;
+    for (int i = 0; i < 5; ++i)
+        interpreter->next_instruction();
+
+    ASSERT_EQ(9, interpreter->m_registers[2]);
+    ASSERT_EQ(0x20A, interpreter->m_program_counter);
+}
+
+// Function to test sprite drawing Dxyn on the packed rows
+// 1. A sprite drawn at the bottom right corner wraps around both edges
+// 2. Drawing over a lit pixel anywhere in the sprite sets VF and turns it off
+TEST_F(Chip8FlatCPU, draw_sprite_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    const std::array<uint8_t, 2> sprite = { 0xF0, 0x90 };
+    interpreter->m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(set_reg_call(0, 62));
+    interpreter->execute(set_reg_call(1, 31));
+    interpreter->execute(display_sprite_call(0, 1, 2));
+
+    // Row 31 holds x = 62, 63, 0, 1 and row 0 holds x = 62 and 1
+    ASSERT_EQ(0xC000000000000003u, interpreter->rows()[31][0]);
+    ASSERT_EQ(0x4000000000000002u, interpreter->rows()[0][0]);
+    ASSERT_EQ(0, interpreter->m_registers[15]);
+    ASSERT_TRUE(interpreter->draw());
+
+    const std::vector<uint32_t> pixels = interpreter->screen();
+    ASSERT_EQ(0xFFFFFFFFu, pixels[31 * 64 + 63]);
+    ASSERT_EQ(0u, pixels[31 * 64 + 2]);
+
+    // 0x90 at x = 60 lights x = 60 and turns x = 63 off. The last pixel drawn, x = 3, did not collide
+    interpreter->execute(set_i_call(0x301));
+    interpreter->execute(set_reg_call(0, 60));
+    interpreter->execute(display_sprite_call(0, 1, 1));
+    ASSERT_EQ(1, interpreter->m_registers[15]);
+    ASSERT_EQ(0xC00000000000000Au, interpreter->rows()[31][0]);
+}
+
+// Function to test every quirk against the default behaviour
+// 1. Unknown quirk sets are refused and leave the set in use alone
+// 2. Each quirk of the VIP and SUPER-CHIP sets changes its opcode, batch runs included
+TEST_F(Chip8FlatCPU, quirks_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    ASSERT_EQ(chip8::QUIRKS_NONE, interpreter->quirks());
+    ASSERT_FALSE(interpreter->set_quirks(chip8::QUIRK_CLIP | chip8::QUIRK_VF_RESET));
+    ASSERT_TRUE(interpreter->set_quirks(chip8::QUIRKS_VIP));
+    ASSERT_EQ(chip8::QUIRKS_VIP, interpreter->quirks());
+
+    // Shifts read Vy, logic ops clear VF
+    interpreter->execute(set_reg_call(1, 0x81));
+    interpreter->execute(shr_reg_call(0) | 1 << 4);
+    ASSERT_EQ(0x40, interpreter->m_registers[0]);
+    ASSERT_EQ(1, interpreter->m_registers[15]);
+    interpreter->execute(or_reg_call(0, 1));
+    ASSERT_EQ(0xC1, interpreter->m_registers[0]);
+    ASSERT_EQ(0, interpreter->m_registers[15]);
+    interpreter->execute(shl_reg_call(2) | 1 << 4);
+    ASSERT_EQ(0x02, interpreter->m_registers[2]);
+    ASSERT_EQ(1, interpreter->m_registers[15]);
+
+    // Stores and loads move I past the registers
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(store_regs_mem_call(2));
+    ASSERT_EQ(0x303u, interpreter->m_index_register);
+    interpreter->execute(read_regs_mem_call(1));
+    ASSERT_EQ(0x305u, interpreter->m_index_register);
+
+    // Sprites are cut at the right and bottom edges
+    const std::array<uint8_t, 2> sprite = { 0xF0, 0x90 };
+    interpreter->m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(set_reg_call(0, 62));
+    interpreter->execute(set_reg_call(1, 31));
+    interpreter->execute(display_sprite_call(0, 1, 2));
+    ASSERT_EQ(0x3u, interpreter->rows()[31][0]);
+    ASSERT_EQ(0u, interpreter->rows()[0][0]);
+
+    // Batch runs use the same handlers: V0 = 2, V1 = 3, 8016 shifts V1 into V0
+    const std::array<uint8_t, 8> program = { 0x60, 0x02, 0x61, 0x03, 0x80, 0x16, 0x12, 0x06 };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+    interpreter->reset();
+    ASSERT_EQ(chip8::QUIRKS_VIP, interpreter->quirks());
+    interpreter->run_cycles(4);
+    ASSERT_EQ(1, interpreter->m_registers[0]);
+
+    // SUPER-CHIP jumps to xnn + Vx
+    ASSERT_TRUE(interpreter->set_quirks(chip8::QUIRKS_SCHIP));
+    interpreter->execute(set_reg_call(0, 0x10));
+    interpreter->execute(set_reg_call(3, 0x04));
+    interpreter->execute(jump_pc_call(0x340));
+    ASSERT_EQ(0x344u, interpreter->m_program_counter);
+
+    ASSERT_TRUE(interpreter->set_quirks(chip8::QUIRKS_NONE));
+    interpreter->execute(jump_pc_call(0x340));
+    ASSERT_EQ(0x350u, interpreter->m_program_counter);
+}
+
+// Function to test the SUPER-CHIP screen and opcodes
+// 1. 00FF and 00FE switch the screen size, clear it and mark every row
+// 2. 16x16 sprites wrap across both words of a row, scrolls move whole rows and words
+// 3. Big font digits, RPL flags and exit
+TEST_F(Chip8FlatCPU, superchip_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    ASSERT_EQ(64u, interpreter->width());
+    interpreter->clear_dirty();
+    interpreter->execute(hires_call());
+    ASSERT_EQ(128u, interpreter->width());
+    ASSERT_EQ(64u, interpreter->height());
+    ASSERT_EQ(~0ull, interpreter->frame().dirty);
+
+    // A 16x16 sprite at x = 120 wraps its right half to x = 0, and from row 63 to row 0
+    std::array<uint8_t, 32> sprite = {};
+    sprite[0] = 0xFF; sprite[1] = 0x01;
+    sprite[2] = 0x80; sprite[3] = 0x00;
+    interpreter->m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(set_reg_call(0, 120));
+    interpreter->execute(set_reg_call(1, 63));
+    interpreter->clear_dirty();
+    interpreter->execute(display_sprite_call(0, 1, 0));
+    ASSERT_EQ(0x0100000000000000u, interpreter->rows()[63][0]);
+    ASSERT_EQ(0xFFu, interpreter->rows()[63][1]);
+    ASSERT_EQ(0x80u, interpreter->rows()[0][1]);
+    ASSERT_EQ(0u, interpreter->m_registers[15]);
+    ASSERT_EQ(1ull | 1ull << 63, interpreter->frame().dirty);
+
+    const std::vector<uint32_t> pixels = interpreter->screen();
+    ASSERT_EQ(128u * 64u, pixels.size());
+    ASSERT_EQ(0xFFFFFFFFu, pixels[63 * 128 + 127]);
+    ASSERT_EQ(0xFFFFFFFFu, pixels[63 * 128 + 7]);
+    ASSERT_EQ(0u, pixels[63 * 128 + 8]);
+
+    // Scrolling right carries bits from the first word into the second, the right edge falls off
+    interpreter->execute(scroll_right_call());
+    ASSERT_EQ(0x0010000000000000u, interpreter->rows()[63][0]);
+    ASSERT_EQ(0x0Fu, interpreter->rows()[63][1]);
+    interpreter->execute(scroll_left_call());
+    ASSERT_EQ(0x0100000000000000u, interpreter->rows()[63][0]);
+    ASSERT_EQ(0xF0u, interpreter->rows()[63][1]);
+
+    // Scrolling down drops the bottom row and blanks the top
+    interpreter->clear_dirty();
+    interpreter->execute(scroll_down_call(2));
+    ASSERT_EQ(0x80u, interpreter->rows()[2][1]);
+    ASSERT_EQ(0u, interpreter->rows()[0][1]);
+    ASSERT_EQ(0u, interpreter->rows()[63][1]);
+    ASSERT_EQ(1ull | 1ull << 2 | 1ull << 63, interpreter->frame().dirty);
+
+    // Low resolution scrolls move low resolution pixels
+    interpreter->execute(lores_call());
+    ASSERT_EQ(64u, interpreter->width());
+    ASSERT_EQ(0u, interpreter->rows()[2][1]);
+    interpreter->execute(set_reg_call(0, 0));
+    interpreter->execute(set_reg_call(1, 0));
+    interpreter->execute(display_sprite_call(0, 1, 1));
+    interpreter->execute(scroll_right_call());
+    ASSERT_EQ(0x0FF0000000000000u, interpreter->rows()[0][0]);
+    ASSERT_EQ(0u, interpreter->rows()[0][1]);
+
+    interpreter->execute(set_reg_call(2, 0xA));
+    interpreter->execute(index_big_sprite_call(2));
+    ASSERT_EQ(chip8::BIG_FONT_START + 100u, interpreter->m_index_register);
+
+    interpreter->execute(set_reg_call(0, 7));
+    interpreter->execute(store_rpl_call(2));
+    interpreter->execute(set_reg_call(0, 0));
+    interpreter->execute(read_rpl_call(0));
+    ASSERT_EQ(7u, interpreter->m_registers[0]);
+    ASSERT_EQ(0xAu, interpreter->m_rpl[2]);
+
+    interpreter->execute(exit_call());
+    ASSERT_TRUE(interpreter->exit());
+}
+
+// Function to test VIP two page roms: they start at 0x2C0 on a 64x64 screen and clear it with 0230
+TEST_F(Chip8FlatCPU, two_page_test)
+{
+    const std::array<uint8_t, 2> jump = { 0x12, 0x60 };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(jump)));
+    interpreter->reset();
+    ASSERT_EQ(0x2C0u, interpreter->pc());
+    ASSERT_EQ(64u, interpreter->width());
+    ASSERT_EQ(64u, interpreter->height());
+
+    const std::array<uint8_t, 1> sprite = { 0x80 };
+    interpreter->m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+    interpreter->execute(0xA300);
+    interpreter->execute(0x6030);
+    interpreter->execute(0x6100);
+    interpreter->execute(0xD101);
+    ASSERT_EQ(0x8000000000000000u, interpreter->rows()[48][0]);
+    interpreter->execute(0x0230);
+    ASSERT_EQ(0u, interpreter->rows()[48][0]);
+
+    // Any other rom ignores 0230 like every 0nnn machine call
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(sprite)));
+    interpreter->reset();
+    interpreter->execute(0xA300);
+    interpreter->execute(0xD101);
+    interpreter->execute(0x0230);
+    ASSERT_EQ(0x8000000000000000u, interpreter->rows()[0][0]);
+}
+
+// Function to test the frame view counters
+// 1. Drawing marks only the rows it touched and bumps the generation
+// 2. Clearing an already clear screen changes nothing
+TEST_F(Chip8FlatCPU, frame_view_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    // Reset marks every row so the first present uploads the whole screen
+    ASSERT_EQ(~0ull, interpreter->frame().dirty);
+    interpreter->clear_dirty();
+    interpreter->execute(clear_scr_call());
+    ASSERT_EQ(0u, interpreter->frame().dirty);
+    const uint64_t generation = interpreter->frame().generation;
+
+    const std::array<uint8_t, 3> sprite = { 0x80, 0x00, 0x80 };
+    interpreter->m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+    interpreter->execute(set_i_call(0x300));
+    interpreter->execute(set_reg_call(0, 4));
+    interpreter->execute(display_sprite_call(0, 1, 3));
+
+    // The empty middle row is left alone
+    const chip8::Interpreter::FrameView frame = interpreter->frame();
+    ASSERT_EQ(0b101u, frame.dirty);
+    ASSERT_EQ(generation + 1, frame.generation);
+    ASSERT_EQ(&interpreter->rows(), &frame.rows);
+
+    interpreter->clear_dirty();
+    interpreter->execute(clear_scr_call());
+    ASSERT_EQ(0b101u, interpreter->frame().dirty);
+    ASSERT_EQ(generation + 2, interpreter->frame().generation);
+}
+
+// Function to test the batch run reasons: cycles, draw, key wait and exit
+TEST_F(Chip8FlatCPU, run_cycles_test)
+{
+    const std::array<uint8_t, 10> program = {
+        0x60, 0x01,     // 200: V0 = 1
+        0x70, 0x01,     // 202: V0 += 1
+        0xD0, 0x01,     // 204: Draw 1 row at (V0, V0)
+        0xF1, 0x0A,     // 206: Wait for a key
+        0x00, 0xEE      // 208: Return with an empty stack, exits
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, interpreter->run_cycles(2));
+    ASSERT_EQ(2, interpreter->m_registers[0]);
+    ASSERT_EQ(2u, interpreter->cycles());
+
+    ASSERT_EQ(chip8::Interpreter::RunResult::DRAW, interpreter->run_until_frame(100));
+    ASSERT_TRUE(interpreter->draw());
+
+    // Fx0A keeps the program counter on itself until a key is down
+    ASSERT_EQ(chip8::Interpreter::RunResult::KEY_WAIT, interpreter->run_cycles(100));
+    ASSERT_EQ(0x206u, interpreter->pc());
+
+    std::array<bool, 16> keys = {};
+    keys[3] = true;
+    interpreter->sync_keys(keys);
+    ASSERT_EQ(chip8::Interpreter::RunResult::EXIT, interpreter->run_cycles(100));
+
+    // The waiting Fx0A counts as executed, so it ran twice
+    ASSERT_EQ(6u, interpreter->cycles());
+}
+
+// Function to test the profile counts of batch and single steps, and the report's disassembly
+TEST_F(Chip8FlatCPU, profile_test)
+{
+    const std::array<uint8_t, 6> program = {
+        0x70, 0x01,     // 200: V0 += 1
+        0x30, 0x05,     // 202: Skip the jump once V0 is 5
+        0x12, 0x00      // 204: Jump back to 200
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    // Nothing is counted while it is off
+    interpreter->run_cycles(3);
+    ASSERT_FALSE(interpreter->profiling());
+
+    interpreter->enable_profiling(true);
+    ASSERT_TRUE(interpreter->profiling());
+    interpreter->run_cycles(9);
+    interpreter->next_instruction();
+
+    // Three loops, then the add of the fourth
+    ASSERT_EQ(4u, interpreter->m_profile->ops[interpreter->OP_7xnn]);
+    ASSERT_EQ(3u, interpreter->m_profile->ops[interpreter->OP_3xnn]);
+    ASSERT_EQ(3u, interpreter->m_profile->ops[interpreter->OP_1nnn]);
+    ASSERT_EQ(4u, interpreter->m_profile->pcs[0x200]);
+    ASSERT_EQ(3u, interpreter->m_profile->pcs[0x204]);
+    ASSERT_EQ(0u, interpreter->m_profile->pcs[0x206]);
+
+    std::ostringstream report;
+    interpreter->write_profile(report, 2);
+    ASSERT_NE(std::string::npos, report.str().find("10 instructions"));
+    ASSERT_NE(std::string::npos, report.str().find("0x200    7001          4  40.00%  ADD V0, 0x01"));
+    ASSERT_EQ(std::string::npos, report.str().find("JP 0x200"));
+
+    ASSERT_EQ("DRW V1, VA, 15", chip8::Interpreter::disassemble(0xD1AF));
+    ASSERT_EQ("LD [I], V3", chip8::Interpreter::disassemble(0xF355));
+    ASSERT_EQ("DW 0x812F", chip8::Interpreter::disassemble(0x812F));
+
+    // Turning it off drops the counts
+    interpreter->enable_profiling(false);
+    ASSERT_EQ(nullptr, interpreter->m_profile);
+}
@@ -0,0 +1,97 @@
+#include <regex>
+#include <sstream>
+
+namespace
+{
+// Log through the singleton into a string, restoring stdout and the silent test level afterwards
+class LoggerCapture
+{
+public:
+    LoggerCapture()
+    {
+        util::Logger::get_instance()->set_output(m_out);
+        util::Logger::get_instance()->set_max_log_level(LOGTYPE::DEBUG);
+    }
+
+    ~LoggerCapture()
+    {
+        util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE);
+        util::Logger::get_instance()->set_output(std::cout);
+    }
+
+    // Everything written so far
+    std::string text()
+    {
+        util::Logger::get_instance()->flush();
+        return m_out.str();
+    }
+
+private:
+    std::ostringstream m_out;
+};
+
+// Sum of the numbers a pattern captures, an empty capture counts as one
+uint64_t count_matches(const std::string &text, const std::regex &pattern)
+{
+    uint64_t sum = 0;
+    for (std::sregex_iterator it(text.begin(), text.end(), pattern), end; it != end; ++it)
+        sum += (*it)[1].length() > 0 ? std::stoull((*it)[1].str()) : 1;
+    return sum;
+}
+} // anonymous namespace
+
+// Function to test the message format, the level filter and that flush waits for the writer
+TEST(LoggerTest, format_test)
+{
+    LoggerCapture capture;
+
+    util::LOG(LOGTYPE::DEBUG, "first");
+    util::LOG(LOGTYPE::ERROR, "second");
+    util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+    util::LOG(LOGTYPE::DEBUG, "filtered");
+
+    ASSERT_EQ("Debug Message: first\n***ERROR*** Message: second\n", capture.text());
+
+    // Cut to a fixed record
+    util::LOG(LOGTYPE::ERROR, std::string(1000, 'x'));
+    ASSERT_NE(std::string::npos, capture.text().find(std::string(util::Logger::MESSAGE_SIZE, 'x') + "\n"));
+}
+
+// Function to test that a flood of one message becomes a line and a repeat count
+TEST(LoggerTest, dedup_test)
+{
+    LoggerCapture capture;
+
+    for (int i = 0; i < 1000; ++i)
+        util::LOG(LOGTYPE::ERROR, "Unknown opcode");
+    util::LOG(LOGTYPE::ERROR, "Another");
+
+    // A full queue drops messages instead of waiting, every one of them is accounted for
+    const std::string text = capture.text();
+    const uint64_t shown = count_matches(text, std::regex("Message: Unknown opcode\n()"));
+    const uint64_t repeated = count_matches(text, std::regex("repeated (\\d+) times"));
+    const uint64_t dropped = count_matches(text, std::regex("(\\d+) log messages dropped"));
+
+    ASSERT_EQ(1u, shown);
+    ASSERT_EQ(1000u, shown + repeated + dropped);
+    ASSERT_NE(std::string::npos, text.find("Message: Another\n"));
+}
+
+// Function to test that distinct messages past the rate are counted instead of written
+TEST(LoggerTest, rate_limit_test)
+{
+    LoggerCapture capture;
+
+    // The writer's one second window can roll at most a few times during the burst
+    constexpr uint64_t COUNT = 5 * util::Logger::LINES_PER_SECOND;
+    for (uint64_t i = 0; i < COUNT; ++i)
+        util::LOG(LOGTYPE::ERROR, "Message " + std::to_string(i));
+
+    const std::string text = capture.text();
+    const uint64_t shown = count_matches(text, std::regex("Message: Message \\d+\n()"));
+    const uint64_t suppressed = count_matches(text, std::regex("(\\d+) log messages suppressed"));
+    const uint64_t dropped = count_matches(text, std::regex("(\\d+) log messages dropped"));
+
+    ASSERT_LT(shown, COUNT);
+    ASSERT_EQ(COUNT, shown + suppressed + dropped);
+}
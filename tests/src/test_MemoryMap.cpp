@@ -5,4 +5,23 @@ TEST(MemoryTest, MemoryMap)
 	std::unique_ptr<chip8::MemoryMap> memory = chip8::MemoryMap::makeMemoryMap(10, 1);
 	ASSERT_ANY_THROW(memory->store(std::byte(10),0) );
 	ASSERT_NO_THROW(memory->store(std::byte(10), 1));
-}
\ No newline at end of file
+}
+
+TEST(MemoryTest, FlatMemory)
+{
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	ASSERT_ANY_THROW(memory->store(std::byte(10), chip8::FlatMemory::SIZE));
+	ASSERT_NO_THROW(memory->store(std::byte(10), 0));
+	ASSERT_EQ(std::byte(10), memory->read(0));
+
+	// Block write past the end of memory wraps back to address 0
+	const std::array<std::byte, 4> block = { std::byte(1), std::byte(2), std::byte(3), std::byte(4) };
+	memory->write_block(chip8::FlatMemory::SIZE - 2, block);
+	ASSERT_EQ(std::byte(1), memory->fetch(chip8::FlatMemory::SIZE - 2));
+	ASSERT_EQ(std::byte(4), memory->fetch(1));
+	ASSERT_EQ(0x0102u, memory->fetch_opcode(chip8::FlatMemory::SIZE - 2));
+
+	std::array<std::byte, 4> out = {};
+	memory->read_block(chip8::FlatMemory::SIZE - 2, out);
+	ASSERT_EQ(block, out);
+}
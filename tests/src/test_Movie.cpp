@@ -0,0 +1,114 @@
+#include <filesystem>
+
+namespace
+{
+// Key dependent random walk that draws every frame
+void load_movie_program(chip8::Interpreter &interpreter)
+{
+    const std::array<uint8_t, 16> program = {
+        0x60, 0x05,     // 200: V0 = 5
+        0xE0, 0xA1,     // 202: Skip next if key V0 is not pressed
+        0xC1, 0x07,     // 204: V1 = rand & 7
+        0x72, 0x01,     // 206: V2 += 1
+        0xA0, 0x50,     // 208: I = font 0
+        0xD1, 0x25,     // 20A: Draw 5 rows at (V1, V2)
+        0x00, 0xE0,     // 20C: Clear screen
+        0x12, 0x02      // 20E: Jump to 202
+    };
+    interpreter.m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+}
+
+// Record a run the way main does, keys set for whole frames
+chip8::Movie record_movie(chip8::Interpreter &interpreter, const std::vector<uint16_t> &keys)
+{
+    chip8::Movie movie;
+    movie.seed = 99;
+    movie.instructions_per_frame = 20;
+    movie.quirks = interpreter.quirks();
+
+    interpreter.seed(movie.seed);
+    interpreter.reset();
+    movie.start_hash = chip8::state_hash(interpreter);
+
+    chip8::SchedulerOptions options;
+    options.instructions_per_frame = movie.instructions_per_frame;
+    options.deterministic = true;
+    chip8::FrameScheduler scheduler(interpreter, options);
+
+    for (const uint16_t &mask : keys)
+    {
+        interpreter.set_key_mask(mask);
+        scheduler.run_frame();
+        movie.keys.push_back(mask);
+        movie.hashes.push_back(chip8::state_hash(interpreter));
+    }
+
+    return movie;
+}
+} // anonymous namespace
+
+// Function to test that a movie replays bit for bit through a file and that desyncs are caught where they happen
+TEST_F(Chip8FlatCPU, movie_replay_test)
+{
+    load_movie_program(*interpreter);
+
+    std::vector<uint16_t> keys(120, 0);
+    for (size_t frame = 30; frame < 60; ++frame)
+        keys[frame] = 1u << 5;
+
+    const chip8::Movie movie = record_movie(*interpreter, keys);
+    const chip8::ScreenRows screen = interpreter->rows();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chip8_movie_test.c8m").string();
+    ASSERT_TRUE(chip8::write_movie(path, movie));
+
+    chip8::Movie loaded;
+    ASSERT_TRUE(chip8::read_movie(path, loaded));
+    std::remove(path.c_str());
+    ASSERT_EQ(movie.keys, loaded.keys);
+    ASSERT_EQ(movie.hashes, loaded.hashes);
+
+    // Same run again, from whatever state the interpreter was left in
+    interpreter->run_cycles(77);
+    chip8::ReplayResult replay = chip8::play_movie(*interpreter, loaded);
+    ASSERT_FALSE(replay.desync);
+    ASSERT_EQ(120u, replay.frames);
+    ASSERT_EQ(120u * 20, replay.cycles);
+    ASSERT_EQ(screen, interpreter->rows());
+
+    // The key only matters while the program reads it, a changed mask shows up in that frame's hash
+    loaded.keys[45] = 0;
+    replay = chip8::play_movie(*interpreter, loaded);
+    ASSERT_TRUE(replay.desync);
+    ASSERT_EQ(45u, replay.frames);
+
+    // Another seed is caught before the first frame
+    loaded = movie;
+    loaded.seed = 100;
+    replay = chip8::play_movie(*interpreter, loaded);
+    ASSERT_TRUE(replay.desync);
+    ASSERT_EQ(0u, replay.frames);
+}
+
+// Function to test that a movie replays with the quirks it was recorded with, whatever the interpreter was set to
+TEST_F(Chip8FlatCPU, movie_quirks_test)
+{
+    load_movie_program(*interpreter);
+    ASSERT_TRUE(interpreter->set_quirks(chip8::QUIRKS_VIP));
+
+    const chip8::Movie movie = record_movie(*interpreter, std::vector<uint16_t>(30, 1u << 5));
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chip8_movie_quirks_test.c8m").string();
+    ASSERT_TRUE(chip8::write_movie(path, movie));
+
+    chip8::Movie loaded;
+    ASSERT_TRUE(chip8::read_movie(path, loaded));
+    std::remove(path.c_str());
+    ASSERT_EQ(chip8::QUIRKS_VIP, loaded.quirks);
+
+    ASSERT_TRUE(interpreter->set_quirks(chip8::QUIRKS_NONE));
+    const chip8::ReplayResult replay = chip8::play_movie(*interpreter, loaded);
+    ASSERT_FALSE(replay.desync);
+    ASSERT_EQ(30u, replay.frames);
+    ASSERT_EQ(chip8::QUIRKS_VIP, interpreter->quirks());
+}
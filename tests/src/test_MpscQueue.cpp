@@ -0,0 +1,66 @@
+#include "../../include/MpscQueue.h"
+
+#include <thread>
+#include <vector>
+
+// Function to test ordering and the full and empty cases
+TEST(MpscQueueTest, fifo_test)
+{
+    chip8::MpscQueue<int, 4> queue;
+    ASSERT_EQ(nullptr, queue.front());
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.push(i));
+    ASSERT_FALSE(queue.push(4));
+
+    // Slots are freed for the next lap as they are popped
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_NE(nullptr, queue.front());
+        ASSERT_EQ(i, *queue.front());
+        queue.pop();
+        ASSERT_TRUE(queue.push(i + 4));
+    }
+}
+
+// Function to test that racing producers lose nothing and each producer's elements stay in order
+TEST(MpscQueueTest, concurrent_test)
+{
+    chip8::MpscQueue<uint64_t, 64> queue;
+    constexpr uint64_t PRODUCERS = 4, COUNT = 25000;
+
+    // Producer in the top bits, sequence number in the rest
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p)
+        producers.emplace_back([&queue, p]()
+        {
+            for (uint64_t i = 1; i <= COUNT; ++i)
+                while (!queue.push((p << 32) | i))
+                    std::this_thread::yield();
+        });
+
+    // Keep reading to the end, the producers have to be joined before any assertion
+    std::vector<uint64_t> last(PRODUCERS, 0);
+    bool out_of_order = false;
+    for (uint64_t received = 0; received < PRODUCERS * COUNT;)
+    {
+        const uint64_t *value = queue.front();
+        if (value == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint64_t producer = *value >> 32, sequence = *value & 0xFFFFFFFF;
+        out_of_order |= producer >= PRODUCERS || sequence != last[producer % PRODUCERS] + 1;
+        last[producer % PRODUCERS] = sequence;
+        queue.pop();
+        ++received;
+    }
+
+    for (std::thread &producer : producers)
+        producer.join();
+
+    ASSERT_FALSE(out_of_order);
+    ASSERT_EQ(nullptr, queue.front());
+}
@@ -0,0 +1,166 @@
+#include <random>
+
+// Interpreter and recompiler running the same memory side by side
+class Chip8Recompiler : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Disable logging for tests
+        util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE);
+
+        if (!jit->enable_jit(true))
+            GTEST_SKIP() << "Recompiler is not supported on this host";
+    }
+
+    // Write the same program into both interpreters
+    void load(std::span<const uint8_t> program)
+    {
+        for (auto *cpu : { interpreter.get(), jit.get() })
+        {
+            cpu->m_ram->write_block(0x200, std::as_bytes(program));
+            cpu->reset();
+        }
+    }
+
+    // Every piece of guest state has to match after each run
+    void expect_same_state(void)
+    {
+        ASSERT_EQ(interpreter->m_registers, jit->m_registers);
+        ASSERT_EQ(interpreter->m_index_register, jit->m_index_register);
+        ASSERT_EQ(interpreter->m_program_counter, jit->m_program_counter);
+        ASSERT_EQ(interpreter->m_delay_timer, jit->m_delay_timer);
+        ASSERT_EQ(interpreter->m_sound_timer, jit->m_sound_timer);
+        ASSERT_EQ(interpreter->m_sp, jit->m_sp);
+        ASSERT_EQ(interpreter->m_stack, jit->m_stack);
+        ASSERT_EQ(interpreter->m_rows, jit->m_rows);
+        ASSERT_EQ(interpreter->m_dirty_rows, jit->m_dirty_rows);
+        ASSERT_EQ(interpreter->m_frame_generation, jit->m_frame_generation);
+        ASSERT_EQ(interpreter->cycles(), jit->cycles());
+        ASSERT_EQ(interpreter->m_exit_flag, jit->m_exit_flag);
+        ASSERT_EQ(interpreter->m_draw_flag, jit->m_draw_flag);
+        ASSERT_TRUE(std::ranges::equal(interpreter->m_ram->data(), jit->m_ram->data()));
+    }
+
+    std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(chip8::FlatMemory::makeFlatMemory());
+    std::unique_ptr<chip8::Interpreter> jit = chip8::Interpreter::make_interpreter(chip8::FlatMemory::makeFlatMemory());
+};
+
+// Function to test random programs of every deterministic opcode against the interpreter handlers, under every quirk set.
+// Stores land on the program too, so translated blocks get invalidated along the way
+TEST_F(Chip8Recompiler, random_program_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    std::mt19937 rng(8);
+    auto random = [&](unsigned int bound) { return (unsigned int)(rng() % bound); };
+
+    const std::array<uint8_t, 4> quirk_sets = { chip8::QUIRKS_NONE, chip8::QUIRKS_VIP, chip8::QUIRKS_SCHIP, chip8::QUIRKS_XOCHIP };
+    for (int round = 0; round < 400; ++round)
+    {
+        const uint8_t quirks = quirk_sets[round % quirk_sets.size()];
+        ASSERT_TRUE(interpreter->set_quirks(quirks));
+        ASSERT_TRUE(jit->set_quirks(quirks));
+
+        std::array<uint8_t, 128> program;
+        for (size_t i = 0; i < program.size(); i += 2)
+        {
+            const unsigned int x = random(16), y = random(16), nn = random(256);
+            const unsigned int target = 0x200 + 2 * random(program.size() / 2);
+            const std::array<unsigned int, 35> opcodes = {
+                clear_scr_call(), ret_subr_call(), set_pc_call(target), subr_call(target),
+                skip_instr_ifeq_call(x, nn), skip_instr_ifneq_call(x, nn), skip_instr_ifeq_reg_call(x, y),
+                set_reg_call(x, nn), add_to_reg_call(x, nn), set_reg_equal_call(x, y), or_reg_call(x, y),
+                and_reg_call(x, y), xor_reg_call(x, y), add_reg_call(x, y), sub_reg_call(x, y), shr_reg_call(x),
+                subn_reg_call(x, y), shl_reg_call(x), skip_instr_ifneq_reg_call(x, y),
+                set_i_call(0x200 + random(0x100)), jump_pc_call(target), display_sprite_call(x, y, random(16)),
+                vx_eq_delay_call(x), wait_for_key_call(x), delay_eq_vx_call(x), sound_eq_vx_call(x), index_add_reg_call(x),
+                index_sprite_call(x), store_bcd_call(x), store_regs_mem_call(x), read_regs_mem_call(x), 0x0000, add_to_reg_call(x, nn),
+                shr_reg_call(x) | y << 4, shl_reg_call(x) | y << 4 };
+            const unsigned int opcode = opcodes[random(opcodes.size())];
+            program[i] = opcode >> 8;
+            program[i + 1] = opcode & 0xFF;
+        }
+        load(program);
+
+        for (int run = 0; run < 20; ++run)
+        {
+            const uint64_t budget = 1 + random(80);
+            const bool frame = random(2);
+            const auto expected = frame ? interpreter->run_until_frame(budget) : interpreter->run_cycles(budget);
+            const auto actual = frame ? jit->run_until_frame(budget) : jit->run_cycles(budget);
+
+            ASSERT_EQ(expected, actual) << "round " << round << ", run " << run << ", quirks " << (int)quirks;
+            expect_same_state();
+            ASSERT_EQ(interpreter->draw(), jit->draw());
+
+            if (expected == chip8::Interpreter::RunResult::EXIT)
+                break;
+
+            // Free key waits every other run
+            std::array<bool, 16> keys = {};
+            keys[random(16)] = random(2);
+            interpreter->sync_keys(keys);
+            jit->sync_keys(keys);
+        }
+    }
+}
+
+// Function to test that a loop is translated once and then chains into itself within the budget
+TEST_F(Chip8Recompiler, chained_loop_test)
+{
+    const std::array<uint8_t, 10> program = {
+        0x70, 0x01,     // 200: V0 += 1
+        0x30, 0x00,     // 202: Skip if V0 == 0
+        0x12, 0x00,     // 204: Jump to 200
+        0x71, 0x01,     // 206: V1 += 1
+        0x12, 0x00      // 208: Jump to 200
+    };
+    load(program);
+
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, jit->run_cycles(1000));
+    ASSERT_EQ(1000u, jit->cycles());
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, interpreter->run_cycles(1000));
+    expect_same_state();
+
+    // 200 to 202, 204 and 206 to 208 once V0 wraps, never translated again
+    ASSERT_EQ(3u, jit->m_jit->translated());
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, jit->run_cycles(5000));
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, interpreter->run_cycles(5000));
+    expect_same_state();
+    ASSERT_EQ(3u, jit->m_jit->translated());
+}
+
+// Function to test that a translated block is dropped once Fx55 stores over it
+TEST_F(Chip8Recompiler, self_modifying_code_test)
+{
+    const std::array<uint8_t, 12> program = {
+        0x60, 0x62,     // 200: V0 = 0x62
+        0x61, 0x09,     // 202: V1 = 0x09
+        0xA2, 0x08,     // 204: I = 0x208
+        0xF1, 0x55,     // 206: Store V0, V1 at 0x208, turning 208 into V2 = 9
+        0x62, 0x01,     // 208: V2 = 1
+        0x12, 0x0A      // 20A: Jump to itself
+    };
+    load(program);
+
+    // Translate 208 as V2 = 1 first
+    jit->m_program_counter = 0x208;
+    jit->run_cycles(1);
+    jit->run_cycles(10);
+    ASSERT_EQ(1, jit->m_registers[2]);
+
+    ASSERT_NE(nullptr, jit->m_jit->m_entry[0x208]);
+
+    // reset() flushes every block, so start over by hand to keep 208 translated up to the store
+    jit->m_program_counter = 0x200;
+    jit->m_registers.fill(0);
+    jit->run_cycles(4);
+    ASSERT_EQ(0x208u, jit->pc());
+    ASSERT_EQ(nullptr, jit->m_jit->m_entry[0x208]);
+
+    jit->run_cycles(10);
+    ASSERT_EQ(9, jit->m_registers[2]);
+    ASSERT_EQ(0x20Au, jit->pc());
+}
@@ -0,0 +1,58 @@
+#include "../../src/Rewind.cpp"
+
+// Function to test that states come back newest first and exactly as pushed
+TEST_F(Chip8FlatCPU, rewind_round_trip_test)
+{
+    const std::array<uint8_t, 10> program = {
+        0xC0, 0x3F,     // 200: V0 = rand & 3F
+        0xC1, 0x1F,     // 202: V1 = rand & 1F
+        0xA0, 0x50,     // 204: I = font 0
+        0xD0, 0x15,     // 206: Draw 5 rows at (V0, V1)
+        0x12, 0x00      // 208: Jump to 200
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    chip8::RewindBuffer history(100, 10);
+    std::vector<chip8::SaveState> states(250);
+    for (chip8::SaveState &state : states)
+    {
+        interpreter->run_cycles(10);
+        interpreter->tick_timers();
+        ASSERT_TRUE(interpreter->save_state(state));
+        history.push(state);
+    }
+
+    // Whole groups are dropped, so the history holds between capacity and capacity plus a group
+    ASSERT_GE(history.size(), 100u);
+    ASSERT_LE(history.size(), 110u);
+
+    // Unchanged memory costs nothing, the deltas are a fraction of the raw states
+    ASSERT_LT(history.bytes(), history.size() * sizeof(chip8::SaveState) / 10);
+
+    // Step back a bit, play forward again, then step back through everything
+    chip8::SaveState state;
+    for (int i = 0; i < 15; ++i)
+    {
+        ASSERT_TRUE(history.pop(state));
+        ASSERT_EQ(0, std::memcmp(&states.back(), &state, sizeof(chip8::SaveState)));
+        states.pop_back();
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(interpreter->load_state(states.back()));
+        interpreter->run_cycles(10);
+        states.emplace_back();
+        interpreter->save_state(states.back());
+        history.push(states.back());
+    }
+
+    const size_t held = history.size();
+    for (size_t i = 0; i < held; ++i)
+    {
+        ASSERT_TRUE(history.pop(state));
+        ASSERT_EQ(0, std::memcmp(&states.back(), &state, sizeof(chip8::SaveState)));
+        states.pop_back();
+    }
+    ASSERT_FALSE(history.pop(state));
+    ASSERT_EQ(0u, history.bytes());
+}
@@ -0,0 +1,95 @@
+#include "../../src/Rom.cpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+// Write bytes to a file under the temp directory
+std::string write_temp_rom(const std::string &name, const std::vector<uint8_t> &bytes)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream f_rom(path, std::ios::binary | std::ios::trunc);
+    f_rom.write((const char*)bytes.data(), bytes.size());
+    return path;
+}
+} // anonymous namespace
+
+// Function to test that every failure comes back as a status and leaves the output alone
+TEST(RomTest, status_test)
+{
+    const std::string empty = write_temp_rom("chip8_rom_empty.ch8", {});
+    const std::string large = write_temp_rom("chip8_rom_large.ch8", std::vector<uint8_t>(chip8::FlatMemory::SIZE - chip8::PROG_START + 1, 0x12));
+    const std::string fits = write_temp_rom("chip8_rom_fits.ch8", std::vector<uint8_t>(chip8::FlatMemory::SIZE - chip8::PROG_START, 0x12));
+
+    std::unique_ptr<chip8::FlatMemory> memory;
+    ASSERT_EQ(chip8::RomStatus::NOT_FOUND, chip8::load_rom(empty + ".missing", memory));
+    ASSERT_EQ(chip8::RomStatus::EMPTY, chip8::load_rom(empty, memory));
+    ASSERT_EQ(chip8::RomStatus::TOO_LARGE, chip8::load_rom(large, memory));
+    ASSERT_EQ(chip8::RomStatus::UNREADABLE, chip8::load_rom(std::filesystem::temp_directory_path().string(), memory));
+    ASSERT_EQ(nullptr, memory);
+
+    std::vector<std::byte> rom;
+    ASSERT_EQ(chip8::RomStatus::OK, chip8::read_rom_file(fits, rom));
+    ASSERT_EQ(chip8::FlatMemory::SIZE - chip8::PROG_START, rom.size());
+    ASSERT_EQ(chip8::RomStatus::TOO_LARGE, chip8::read_rom_file(large, rom));
+    ASSERT_TRUE(rom.empty());
+
+    std::filesystem::remove(empty);
+    std::filesystem::remove(large);
+    std::filesystem::remove(fits);
+}
+
+// Function to test that a loaded rom has the font, the rom at the program start and zeros elsewhere
+TEST(RomTest, load_rom_test)
+{
+    const std::string path = write_temp_rom("chip8_rom_load.ch8", { 0x60, 0x05, 0x12, 0x00 });
+
+    std::unique_ptr<chip8::FlatMemory> memory;
+    ASSERT_EQ(chip8::RomStatus::OK, chip8::load_rom(path, memory));
+    ASSERT_NE(nullptr, memory);
+
+    ASSERT_EQ(chip8::FONTSET[0], (uint8_t)memory->fetch(chip8::FONT_START));
+    ASSERT_EQ(chip8::FONTSET[79], (uint8_t)memory->fetch(chip8::FONT_START + 79));
+    ASSERT_EQ(0x6005u, memory->fetch_opcode(chip8::PROG_START));
+    ASSERT_EQ(0x1200u, memory->fetch_opcode(chip8::PROG_START + 2));
+    ASSERT_EQ(0, (uint8_t)memory->fetch(chip8::PROG_START + 4));
+
+    // The cached image is the same memory
+    chip8::RomCache cache;
+    std::shared_ptr<const chip8::RomImage> image;
+    ASSERT_EQ(chip8::RomStatus::OK, cache.load(path, image));
+    ASSERT_EQ(4u, image->size);
+    ASSERT_EQ(chip8::rom_hash(image->rom()), image->hash);
+    ASSERT_EQ(0, std::memcmp(image->memory.data(), memory->data().data(), chip8::FlatMemory::SIZE));
+
+    std::filesystem::remove(path);
+}
+
+// Function to test that copies of a rom share one image and different roms do not
+TEST(RomTest, cache_test)
+{
+    const std::string first = write_temp_rom("chip8_rom_first.ch8", { 0x60, 0x05, 0x12, 0x00 });
+    const std::string copy = write_temp_rom("chip8_rom_copy.ch8", { 0x60, 0x05, 0x12, 0x00 });
+    const std::string other = write_temp_rom("chip8_rom_other.ch8", { 0x60, 0x06, 0x12, 0x00 });
+
+    chip8::RomCache cache;
+    std::shared_ptr<const chip8::RomImage> a, b, c;
+    ASSERT_EQ(chip8::RomStatus::OK, cache.load(first, a));
+    ASSERT_EQ(chip8::RomStatus::OK, cache.load(copy, b));
+    ASSERT_EQ(chip8::RomStatus::OK, cache.load(other, c));
+    ASSERT_EQ(chip8::RomStatus::NOT_FOUND, cache.load(first + ".missing", c));
+
+    ASSERT_EQ(a.get(), b.get());
+    ASSERT_NE(a.get(), c.get());
+    ASSERT_EQ(2u, cache.size());
+
+    // Images outlive the cache's references
+    cache.clear();
+    ASSERT_EQ(0u, cache.size());
+    ASSERT_EQ(0x6006u, (unsigned int)(((uint8_t)c->memory[chip8::PROG_START] << 8) | (uint8_t)c->memory[chip8::PROG_START + 1]));
+
+    std::filesystem::remove(first);
+    std::filesystem::remove(copy);
+    std::filesystem::remove(other);
+}
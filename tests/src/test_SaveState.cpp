@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <filesystem>
+
+namespace
+{
+// Random sprites, a timer write and a subroutine call in a loop
+void load_state_program(chip8::Interpreter &interpreter)
+{
+    const std::array<uint8_t, 20> program = {
+        0xC0, 0x3F,     // 200: V0 = rand & 3F
+        0xC1, 0x1F,     // 202: V1 = rand & 1F
+        0xA3, 0x00,     // 204: I = 300
+        0xD0, 0x15,     // 206: Draw 5 rows at (V0, V1)
+        0xF0, 0x15,     // 208: Delay = V0
+        0x22, 0x10,     // 20A: Call 210
+        0x12, 0x00,     // 20C: Jump to 200
+        0x00, 0x00,     // 20E: Unused
+        0x72, 0x01,     // 210: V2 += 1
+        0x00, 0xEE      // 212: Return
+    };
+    const std::array<uint8_t, 5> sprite = { 0xF0, 0x90, 0xF0, 0x90, 0xF0 };
+
+    interpreter.m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+    interpreter.m_ram->write_block(0x300, std::as_bytes(std::span(sprite)));
+    interpreter.reset();
+}
+} // anonymous namespace
+
+// Function to test that a run continued from a loaded state matches the run it was saved from
+TEST_F(Chip8FlatCPU, save_state_resume_test)
+{
+    load_state_program(*interpreter);
+    interpreter->seed(7);
+    interpreter->run_cycles(1001);
+
+    chip8::SaveState saved;
+    ASSERT_TRUE(interpreter->save_state(saved));
+    ASSERT_EQ(chip8::SaveState::MAGIC, saved.magic);
+    ASSERT_EQ(1001u, saved.cycles);
+
+    // Reference continuation
+    interpreter->run_cycles(1000);
+    chip8::SaveState expected;
+    interpreter->save_state(expected);
+
+    // Diverge, then come back
+    interpreter->seed(8);
+    interpreter->run_cycles(333);
+    ASSERT_TRUE(interpreter->load_state(saved));
+    interpreter->run_cycles(1000);
+
+    chip8::SaveState resumed;
+    interpreter->save_state(resumed);
+    ASSERT_EQ(0, std::memcmp(&expected, &resumed, sizeof(chip8::SaveState)));
+}
+
+// Function to test rejected states and the file round trip
+TEST_F(Chip8FlatCPU, save_state_file_test)
+{
+    load_state_program(*interpreter);
+    interpreter->run_cycles(500);
+
+    chip8::SaveState saved;
+    interpreter->save_state(saved);
+
+    // Bad headers or stack pointers leave the interpreter alone
+    chip8::SaveState bad = saved;
+    bad.version += 1;
+    ASSERT_FALSE(interpreter->load_state(bad));
+    bad = saved;
+    bad.sp = 17;
+    ASSERT_FALSE(interpreter->load_state(bad));
+    bad = saved;
+    bad.width = 96;
+    ASSERT_FALSE(interpreter->load_state(bad));
+    bad = saved;
+    bad.quirks = chip8::QUIRK_CLIP;
+    ASSERT_FALSE(interpreter->load_state(bad));
+    ASSERT_EQ(500u, interpreter->cycles());
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chip8_save_state_test.c8s").string();
+    ASSERT_TRUE(chip8::write_state(path, saved));
+
+    chip8::SaveState loaded;
+    ASSERT_TRUE(chip8::read_state(path, loaded));
+    ASSERT_EQ(0, std::memcmp(&saved, &loaded, sizeof(chip8::SaveState)));
+
+    // Truncated files are not states
+    std::filesystem::resize_file(path, sizeof(chip8::SaveState) - 1);
+    ASSERT_FALSE(chip8::read_state(path, loaded));
+    std::remove(path.c_str());
+
+    // Memory that is not flat can not be captured
+    std::unique_ptr<chip8::Interpreter> mapped = chip8::Interpreter::make_interpreter(chip8::MemoryMap::makeMemoryMap(0x1000));
+    ASSERT_FALSE(mapped->save_state(saved));
+    ASSERT_FALSE(mapped->load_state(saved));
+}
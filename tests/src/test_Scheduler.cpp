@@ -0,0 +1,154 @@
+#include "../../src/Scheduler.cpp"
+#include "../../src/Headless.cpp"
+
+// Function to test that a deterministic frame runs its instruction budget and ticks the timers once
+TEST_F(Chip8FlatCPU, scheduler_deterministic_test)
+{
+    // For opcode generators
+    using namespace chip8::util;
+
+    const std::array<uint8_t, 2> program = {
+        0x12, 0x00      // 200: Jump to itself
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    interpreter->execute(set_reg_call(0, 3));
+    interpreter->execute(delay_eq_vx_call(0));
+    interpreter->execute(sound_eq_vx_call(0));
+
+    chip8::SchedulerOptions options;
+    options.instructions_per_frame = 500;
+    options.deterministic = true;
+    chip8::FrameScheduler scheduler(*interpreter, options);
+
+    // Timers no longer move per instruction
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, scheduler.run_frame());
+    ASSERT_EQ(500u, interpreter->cycles());
+    ASSERT_EQ(2u, interpreter->delay());
+
+    scheduler.run_frame();
+    scheduler.run_frame();
+    scheduler.run_frame();
+    ASSERT_EQ(0u, interpreter->delay());
+    ASSERT_EQ(0u, interpreter->sound());
+    ASSERT_EQ(4u, scheduler.frames());
+    ASSERT_EQ(2000u, interpreter->cycles());
+}
+
+// Function to test that paced frames start no earlier than their 60 Hz deadlines
+TEST_F(Chip8FlatCPU, scheduler_paced_test)
+{
+    const std::array<uint8_t, 2> program = {
+        0x12, 0x00      // 200: Jump to itself
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    chip8::FrameScheduler scheduler(*interpreter, chip8::SchedulerOptions());
+
+    // The first frame is due at once, the sixth five periods later
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 6; ++i)
+        scheduler.run_frame();
+
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(5 * 16666));
+    ASSERT_EQ(60u, interpreter->cycles());
+}
+
+// Function to test that a key transition takes effect exactly at its cycle within the frame
+TEST_F(Chip8FlatCPU, scheduler_key_input_cycle_test)
+{
+    const std::array<uint8_t, 8> program = {
+        0x71, 0x01,     // 200: V1 += 1
+        0xE0, 0xA1,     // 202: Skip next if key V0 is not pressed
+        0x12, 0x04,     // 204: Jump to itself
+        0x12, 0x00      // 206: Jump to 200
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+    interpreter->m_registers[0] = 5;
+
+    chip8::SchedulerOptions options;
+    options.instructions_per_frame = 100;
+    options.deterministic = true;
+    chip8::FrameScheduler scheduler(*interpreter, options);
+
+    // Ten loops of three instructions run before key 5 goes down, the eleventh sees it
+    const std::array<chip8::KeyInput, 1> inputs = {{ { 30, 5, true } }};
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, scheduler.run_frame(100, inputs));
+    ASSERT_EQ(11u, interpreter->m_registers[1]);
+    ASSERT_EQ(0x204u, interpreter->pc());
+    ASSERT_EQ(1u << 5, interpreter->key_mask());
+}
+
+// Function to test that a key wait idles until the transition that ends it
+TEST_F(Chip8FlatCPU, scheduler_key_wait_test)
+{
+    const std::array<uint8_t, 4> program = {
+        0xF2, 0x0A,     // 200: Wait for a key
+        0x12, 0x02      // 202: Jump to itself
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    chip8::SchedulerOptions options;
+    options.instructions_per_frame = 100;
+    options.deterministic = true;
+    chip8::FrameScheduler scheduler(*interpreter, options);
+
+    // No input, the frame ends early in the wait
+    ASSERT_EQ(chip8::Interpreter::RunResult::KEY_WAIT, scheduler.run_frame());
+    ASSERT_EQ(0x200u, interpreter->pc());
+
+    // Press and release within one frame, the press alone releases the wait
+    const std::array<chip8::KeyInput, 2> inputs = {{ { 40, 0xA, true }, { 60, 0xA, false } }};
+    ASSERT_EQ(chip8::Interpreter::RunResult::CYCLES, scheduler.run_frame(100, inputs));
+    ASSERT_EQ(0x202u, interpreter->pc());
+    ASSERT_EQ(0u, interpreter->key_mask());
+}
+
+// Function to test that a deterministic run applies every queued transition at the start of the frame
+TEST_F(Chip8FlatCPU, scheduler_input_queue_test)
+{
+    const std::array<uint8_t, 2> program = {
+        0x12, 0x00      // 200: Jump to itself
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    chip8::SchedulerOptions options;
+    options.deterministic = true;
+    chip8::FrameScheduler scheduler(*interpreter, options);
+
+    chip8::InputQueue queue;
+    const auto now = std::chrono::steady_clock::now();
+    ASSERT_TRUE(queue.push({ now, 1, true }));
+    ASSERT_TRUE(queue.push({ now, 2, true }));
+    ASSERT_TRUE(queue.push({ now, 1, false }));
+
+    scheduler.run_frame(queue);
+    ASSERT_EQ(nullptr, queue.front());
+    ASSERT_EQ(1u << 2, interpreter->key_mask());
+    ASSERT_EQ(10u, interpreter->cycles());
+}
+
+// Function to test that a loop check past the end of memory wraps like instruction fetches instead of throwing
+TEST_F(Chip8FlatCPU, headless_loop_past_memory_end_test)
+{
+    const std::array<uint8_t, 4> program = {
+        0x60, 0xFF,     // 200: V0 = FF
+        0xBF, 0x01      // 202: Jump to F01 + V0 = 1000
+    };
+    const std::array<uint8_t, 2> wrapped = {
+        0x10, 0x00      // 000: Jump to itself, fetched at 1000
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+    interpreter->m_ram->write_block(0x000, std::as_bytes(std::span(wrapped)));
+    interpreter->reset();
+
+    chip8::RunLimits limits;
+    limits.max_frames = 10;
+    limits.instructions_per_frame = 1;
+    limits.stop_on_loop = true;
+
+    chip8::RunStats stats;
+    ASSERT_NO_THROW(stats = chip8::run_headless(*interpreter, limits, {}));
+    ASSERT_EQ(chip8::StopReason::PC_LOOP, stats.reason);
+    ASSERT_EQ(0x1000u, interpreter->pc());
+}
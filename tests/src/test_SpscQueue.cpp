@@ -0,0 +1,58 @@
+#include "../../include/SpscQueue.h"
+
+#include <thread>
+
+// Function to test ordering and the full and empty cases
+TEST(SpscQueueTest, fifo_test)
+{
+    chip8::SpscQueue<int, 4> queue;
+    ASSERT_EQ(nullptr, queue.front());
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.push(i));
+    ASSERT_FALSE(queue.push(4));
+
+    // Indices wrap around the ring
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_NE(nullptr, queue.front());
+        ASSERT_EQ(i, *queue.front());
+        queue.pop();
+        ASSERT_TRUE(queue.push(i + 4));
+    }
+}
+
+// Function to test that a consumer racing a producer sees every element once and in order
+TEST(SpscQueueTest, concurrent_test)
+{
+    chip8::SpscQueue<uint64_t, 64> queue;
+    constexpr uint64_t COUNT = 100000;
+
+    std::thread producer([&]()
+    {
+        for (uint64_t i = 1; i <= COUNT; ++i)
+            while (!queue.push(i))
+                std::this_thread::yield();
+    });
+
+    // Keep reading to the end, the producer has to be joined before any assertion
+    uint64_t expected = 1;
+    bool out_of_order = false;
+    while (expected <= COUNT)
+    {
+        const uint64_t *value = queue.front();
+        if (value == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        out_of_order |= *value != expected;
+        queue.pop();
+        ++expected;
+    }
+
+    producer.join();
+    ASSERT_FALSE(out_of_order);
+    ASSERT_EQ(nullptr, queue.front());
+}
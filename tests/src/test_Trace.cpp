@@ -0,0 +1,84 @@
+// Function to test that the ring keeps the newest records, oldest first, and samples
+TEST(TraceRing, ring_order_test)
+{
+    std::unique_ptr<chip8::TraceRing> ring = chip8::TraceRing::make_trace_ring(5);
+    ASSERT_EQ(8u, ring->capacity());
+
+    for (uint64_t cycle = 0; cycle < 20; ++cycle)
+        ring->record({ cycle, 0x200, 0x00E0, 0, 0, 0 });
+
+    const std::vector<chip8::TraceRecord> records = ring->records();
+    ASSERT_EQ(20u, ring->written());
+    ASSERT_EQ(8u, records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+        ASSERT_EQ(12 + i, records[i].cycle);
+
+    // One in three, starting with the first
+    std::unique_ptr<chip8::TraceRing> sampled = chip8::TraceRing::make_trace_ring(16, 3);
+    for (uint64_t cycle = 0; cycle < 10; ++cycle)
+        sampled->record({ cycle, 0x200, 0x00E0, 0, 0, 0 });
+
+    ASSERT_EQ(4u, sampled->written());
+    ASSERT_EQ(9u, sampled->records().back().cycle);
+}
+
+// Function to test that batch runs and single steps record the same instructions
+TEST_F(Chip8FlatCPU, trace_interpreter_test)
+{
+    const std::array<uint8_t, 8> program = {
+        0x60, 0x07,     // 200: V0 = 7
+        0xA3, 0x00,     // 202: I = 300
+        0x80, 0x04,     // 204: V0 += V0
+        0x12, 0x04      // 206: Jump to 204
+    };
+    interpreter->m_ram->write_block(0x200, std::as_bytes(std::span(program)));
+
+    interpreter->set_trace(chip8::TraceRing::make_trace_ring(16));
+    interpreter->run_cycles(4);
+    interpreter->next_instruction();
+
+    const std::vector<chip8::TraceRecord> records = interpreter->trace()->records();
+    ASSERT_EQ(5u, records.size());
+
+    ASSERT_EQ(0u, records[0].cycle);
+    ASSERT_EQ(0x200, records[0].pc);
+    ASSERT_EQ(0x6007, records[0].opcode);
+    ASSERT_EQ(7, records[0].vx);
+
+    ASSERT_EQ(0x300, records[1].index);
+    ASSERT_EQ(14, records[2].vx);
+
+    // The jump records where it was fetched from, not where it went
+    ASSERT_EQ(0x206, records[3].pc);
+    ASSERT_FALSE(chip8::writes_vx(records[3].opcode));
+
+    ASSERT_EQ(4u, records[4].cycle);
+    ASSERT_EQ(0x204, records[4].pc);
+    ASSERT_EQ(28, records[4].vx);
+    ASSERT_TRUE(chip8::writes_vx(records[4].opcode));
+}
+
+// Function to test that a mapped ring reads back from its file while still mapped
+TEST(TraceRing, mapped_file_test)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "chip8_trace_test.c8t").string();
+
+    std::unique_ptr<chip8::TraceRing> ring = chip8::TraceRing::map_trace_file(path, 4);
+    ASSERT_NE(nullptr, ring);
+    for (uint64_t cycle = 0; cycle < 6; ++cycle)
+        ring->record({ cycle, (uint16_t)(0x200 + 2 * cycle), 0x7001, 0x123, 1, (uint8_t)cycle });
+
+    chip8::TraceHeader header;
+    std::vector<chip8::TraceRecord> records;
+    ASSERT_TRUE(chip8::read_trace(path, header, records));
+    ASSERT_EQ(6u, header.written);
+    ASSERT_EQ(4u, header.capacity);
+    ASSERT_EQ(4u, records.size());
+    ASSERT_EQ(2u, records.front().cycle);
+    ASSERT_EQ(0x20A, records.back().pc);
+    ASSERT_EQ(5, records.back().vx);
+
+    ring.reset();
+    std::filesystem::remove(path);
+    ASSERT_FALSE(chip8::read_trace(path, header, records));
+}
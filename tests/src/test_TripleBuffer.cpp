@@ -0,0 +1,64 @@
+#include "../../include/TripleBuffer.h"
+
+#include <thread>
+
+// Function to test that the reader only sees published values, and always the latest
+TEST(TripleBufferTest, latest_value_test)
+{
+    chip8::TripleBuffer<int> buffer;
+    ASSERT_FALSE(buffer.update());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    // 1 was overwritten before the reader got to it
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(2, buffer.front());
+    ASSERT_FALSE(buffer.update());
+    ASSERT_EQ(2, buffer.front());
+
+    // Writing without publishing is invisible
+    buffer.back() = 3;
+    ASSERT_FALSE(buffer.update());
+    buffer.publish();
+    ASSERT_TRUE(buffer.update());
+    ASSERT_EQ(3, buffer.front());
+}
+
+// Function to test that a reader racing a writer never sees a torn or older value
+TEST(TripleBufferTest, concurrent_test)
+{
+    struct Payload { std::array<uint64_t, 32> words; };
+    chip8::TripleBuffer<Payload> buffer;
+    constexpr uint64_t COUNT = 100000;
+
+    std::thread writer([&]()
+    {
+        for (uint64_t i = 1; i <= COUNT; ++i)
+        {
+            buffer.back().words.fill(i);
+            buffer.publish();
+        }
+    });
+
+    // Keep reading to the end, the writer has to be joined before any assertion
+    uint64_t last = 0;
+    bool torn = false, older = false;
+    while (last < COUNT)
+    {
+        if (!buffer.update())
+            continue;
+
+        const Payload &payload = buffer.front();
+        for (const uint64_t &word : payload.words)
+            torn |= word != payload.words[0];
+        older |= payload.words[0] <= last;
+        last = payload.words[0];
+    }
+
+    writer.join();
+    ASSERT_FALSE(torn);
+    ASSERT_FALSE(older);
+}
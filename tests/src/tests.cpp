@@ -3,6 +3,18 @@
 
 #include "test_MemoryMap.cpp"
 #include "test_Interpreter.cpp"
+#include "test_Rom.cpp"
+#include "test_Catalogue.cpp"
+#include "test_Recompiler.cpp"
+#include "test_Scheduler.cpp"
+#include "test_SaveState.cpp"
+#include "test_Rewind.cpp"
+#include "test_Movie.cpp"
+#include "test_Trace.cpp"
+#include "test_TripleBuffer.cpp"
+#include "test_SpscQueue.cpp"
+#include "test_MpscQueue.cpp"
+#include "test_Logger.cpp"
 
 int main(int argc, char **argv){
 	testing::InitGoogleTest(&argc, argv);
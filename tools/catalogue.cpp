@@ -0,0 +1,169 @@
+// Rom catalogue. Scans a corpus into an index file once, so batch tools can open it instead of walking and hashing the tree
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Catalogue.h"
+#include "../include/Logger.h"
+
+namespace
+{
+const char *USAGE =
+	"Usage: catalogue [options]\n"
+	"  --roms DIR    rom corpus to scan recursively (default roms)\n"
+	"  --out FILE    index file to write (default roms.c8i)\n"
+	"  --show FILE   list an existing index instead of scanning\n"
+	"  --check FILE  list roms changed or added since an existing index was written, exits 1 when there are any\n";
+
+// Print usage and quit
+[[noreturn]] void usage_error(const std::string &msg)
+{
+	util::LOG(LOGTYPE::ERROR, msg);
+	util::Logger::get_instance()->flush();
+	std::cerr << USAGE;
+	std::exit(1);
+}
+
+// Quirk flags as letters, a dash for each one off
+std::string quirk_letters(const uint8_t &quirks)
+{
+	const char letters[] = "SIJCV";
+	std::string text;
+	for (unsigned int i = 0; i < 5; ++i)
+		text += (quirks >> i) & 1 ? letters[i] : '-';
+	return text;
+}
+
+// One line per rom, duplicates name the first path with their contents
+void show(const chip8::Catalogue &catalogue)
+{
+	std::vector<const chip8::CatalogueEntry *> first(catalogue.groups(), nullptr);
+	char line[128];
+
+	std::cout << catalogue.size() << " roms, " << catalogue.groups() << " distinct, under " << catalogue.root() << "\n"
+			  << "quirks: S shift Vy, I memory increment, J jump Vx, C clip, V VF reset\n\n"
+			  << "hash              size  platform      quirks  ipf   path\n";
+
+	for (size_t i = 0; i < catalogue.size(); ++i)
+	{
+		const chip8::CatalogueEntry &entry = catalogue[i];
+		std::snprintf(line, sizeof(line), "%016llx  %4u  %-12s  %s   %4u  ", (unsigned long long)entry.hash, entry.size,
+					  chip8::to_string(entry.platform), quirk_letters(entry.quirks).c_str(), entry.instructions_per_frame);
+		std::cout << line << catalogue.text(entry.path);
+
+		if (entry.group < first.size())
+		{
+			if (first[entry.group])
+				std::cout << " (same as " << catalogue.text(first[entry.group]->path) << ")";
+			else
+				first[entry.group] = &entry;
+		}
+		std::cout << "\n";
+
+		if (!catalogue.text(entry.title).empty())
+		{
+			std::cout << "    " << catalogue.text(entry.title);
+			if (!catalogue.text(entry.author).empty())
+				std::cout << " by " << catalogue.text(entry.author);
+			if (!catalogue.text(entry.date).empty())
+				std::cout << ", " << catalogue.text(entry.date);
+			if (!catalogue.text(entry.system).empty())
+				std::cout << ", for " << catalogue.text(entry.system);
+			std::cout << (catalogue.text(entry.notes).empty() ? "" : ", has notes") << "\n";
+		}
+	}
+}
+} // anonymous namespace
+
+int main(int argc, char **argv){
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+
+	std::string rom_dir = "roms", out_path = "roms.c8i", show_path, check_path;
+
+	// Process input arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc)
+				usage_error("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		if (arg == "--roms")
+			rom_dir = value();
+		else if (arg == "--out")
+			out_path = value();
+		else if (arg == "--show")
+			show_path = value();
+		else if (arg == "--check")
+			check_path = value();
+		else
+			usage_error("Invalid CL argument " + arg);
+	}
+
+	if (!show_path.empty() || !check_path.empty())
+	{
+		std::unique_ptr<chip8::Catalogue> catalogue = chip8::Catalogue::open_catalogue(show_path.empty() ? check_path : show_path);
+		if (!catalogue)
+			return 1;
+
+		if (!show_path.empty())
+		{
+			show(*catalogue);
+			return 0;
+		}
+
+		unsigned int stale = 0;
+		for (size_t i = 0; i < catalogue->size(); ++i)
+		{
+			if (!catalogue->stale((*catalogue)[i]))
+				continue;
+
+			std::cout << "stale: " << catalogue->text((*catalogue)[i].path) << "\n";
+			++stale;
+		}
+		// New files are found by name alone, nothing is read
+		std::error_code error;
+		const std::string root(catalogue->root());
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(root, error))
+		{
+			if (!entry.is_regular_file() || entry.path().extension() == ".txt")
+				continue;
+
+			const std::string path = std::filesystem::relative(entry.path(), root).generic_string();
+			if (catalogue->find(std::string_view(path)))
+				continue;
+
+			std::cout << "new: " << path << "\n";
+			++stale;
+		}
+
+		std::cout << stale << " of " << catalogue->size() << " roms changed or added since the scan\n";
+		return stale == 0 ? 0 : 1;
+	}
+
+	std::vector<chip8::CatalogueRecord> records;
+	if (!chip8::scan_corpus(rom_dir, records) || records.empty())
+		usage_error("No roms found in " + rom_dir);
+
+	if (!chip8::write_catalogue(out_path, rom_dir, records))
+		return 1;
+
+	unsigned int counts[4] = {}, groups = 0;
+	for (const chip8::CatalogueRecord &record : records)
+	{
+		++counts[(size_t)record.platform];
+		groups = std::max(groups, record.group + 1);
+	}
+
+	std::cout << records.size() << " roms, " << groups << " distinct, written to " << out_path << "\n";
+	for (unsigned int p = 0; p < 4; ++p)
+		std::cout << "  " << chip8::to_string((chip8::Platform)p) << ": " << counts[p] << "\n";
+
+	return 0;
+}
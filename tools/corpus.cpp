@@ -0,0 +1,385 @@
+// Corpus benchmark. Runs every rom for a fixed number of frames, writes per rom throughput as JSON and checks it against a baseline
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../include/Catalogue.h"
+#include "../include/Headless.h"
+#include "../include/Interpreter.h"
+#include "../include/Logger.h"
+#include "../include/Rom.h"
+
+namespace
+{
+const char *USAGE =
+	"Usage: corpus [options]\n"
+	"  --roms DIR       rom corpus to scan recursively (default roms)\n"
+	"  --index FILE     take the roms from an index written by catalogue instead of scanning\n"
+	"  --frames N       frames per rom (default 3600)\n"
+	"  --ipf N          instructions per frame (default 10)\n"
+	"  --samples N      timed samples per rom, the lower quartile of their times counts (default 12)\n"
+	"  --sample-time S  back to back runs in one sample until they took S seconds (default 0.01)\n"
+	"  --out FILE       write results as JSON to FILE (default stdout)\n"
+	"  --baseline FILE  compare against results written by an earlier run\n"
+	"  --threshold F    slowdown against the baseline that fails a rom (default 0.2 for 20%)\n"
+	"  --jit            translate blocks to x86-64 code, interpreting when unsupported\n";
+
+// Print usage and quit. Logging is off while the roms run, so the reason goes straight to stderr
+[[noreturn]] void usage_error(const std::string &msg)
+{
+	std::cerr << msg << "\n" << USAGE;
+	std::exit(1);
+}
+
+// Throughput of one rom, cycles and frames of one run and the seconds it took
+struct RomResult
+{
+	std::string rom;
+	uint64_t cycles = 0, frames = 0;
+	double seconds = 0.0;
+
+	double mips(void) const { return seconds > 0 ? cycles / seconds / 1e6 : 0.0; }
+	double fps(void) const { return seconds > 0 ? frames / seconds : 0.0; }
+};
+
+// Same input for every rom: one key after another, held for 5 frames every 30, so menus are left and games played
+std::vector<chip8::KeyEvent> default_script(const uint64_t &frames)
+{
+	std::vector<chip8::KeyEvent> script;
+	for (uint64_t frame = 30; frame < frames; frame += 30)
+	{
+		const uint8_t key = (frame / 30) % 16;
+		script.push_back({ frame, key, true });
+		script.push_back({ frame + 5, key, false });
+	}
+	return script;
+}
+
+// Quote a string for JSON
+std::string json_string(const std::string &text)
+{
+	std::string quoted = "\"";
+	for (const char &c : text)
+	{
+		if (c == '"' || c == '\\')
+			quoted += '\\';
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+void write_json(std::ostream &out, const std::vector<RomResult> &results, const uint64_t &frames, const unsigned int &ipf)
+{
+	uint64_t cycles = 0;
+	double seconds = 0.0;
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\n  \"frames\": " << frames << ",\n  \"instructions_per_frame\": " << ipf << ",\n  \"roms\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const RomResult &result = results[i];
+		out << "    { \"rom\": " << json_string(result.rom) << ", \"cycles\": " << result.cycles << ", \"frames\": " << result.frames
+			<< ", \"seconds\": " << std::setprecision(6) << result.seconds << std::setprecision(3)
+			<< ", \"mips\": " << result.mips() << ", \"fps\": " << result.fps() << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+
+		cycles += result.cycles;
+		seconds += result.seconds;
+	}
+	out << "  ],\n  \"total_mips\": " << (seconds > 0 ? cycles / seconds / 1e6 : 0.0) << "\n}\n";
+}
+
+// Workload and per rom results of an earlier run
+struct Baseline
+{
+	uint64_t frames = 0;
+	unsigned int instructions_per_frame = 0;
+
+	struct Rom
+	{
+		uint64_t cycles = 0;
+		double mips = 0.0;
+	};
+	std::map<std::string, Rom> roms;
+};
+
+// Value of "key": on a line, npos if the line has none
+size_t find_field(const std::string &line, const std::string &key)
+{
+	const std::string field = "\"" + key + "\": ";
+	const size_t found = line.find(field);
+	return found == std::string::npos ? found : found + field.size();
+}
+
+// Read a file written by write_json. Only reads the fields this tool writes, one rom per line
+bool read_baseline(const std::string &path, Baseline &baseline)
+{
+	std::ifstream f_baseline(path);
+	if (!f_baseline.is_open())
+		return false;
+
+	std::string line;
+	while (std::getline(f_baseline, line))
+	{
+		const size_t rom = find_field(line, "rom");
+		if (rom == std::string::npos)
+		{
+			// Workload lines come before the roms
+			if (const size_t frames = find_field(line, "frames"); frames != std::string::npos)
+				baseline.frames = std::strtoull(line.c_str() + frames, nullptr, 10);
+			else if (const size_t ipf = find_field(line, "instructions_per_frame"); ipf != std::string::npos)
+				baseline.instructions_per_frame = (unsigned int)std::strtoul(line.c_str() + ipf, nullptr, 10);
+			continue;
+		}
+
+		const size_t cycles = find_field(line, "cycles");
+		const size_t mips = find_field(line, "mips");
+		if (cycles == std::string::npos || mips == std::string::npos)
+			continue;
+
+		std::string name;
+		for (size_t i = rom + 1; i < line.size() && line[i] != '"'; ++i)
+		{
+			if (line[i] == '\\' && i + 1 < line.size())
+				++i;
+			name += line[i];
+		}
+
+		baseline.roms[name] = { std::strtoull(line.c_str() + cycles, nullptr, 10), std::strtod(line.c_str() + mips, nullptr) };
+	}
+	return true;
+}
+} // anonymous namespace
+
+int main(int argc, char **argv){
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE);
+
+	std::string rom_dir = "roms", index_path, out_path, baseline_path;
+	chip8::RunLimits limits;
+	limits.max_frames = 3600;
+	limits.stop_on_loop = false;
+	unsigned int samples = 12;
+	double sample_time = 0.01;
+	double threshold = 0.2;
+	bool jit = false;
+
+	// Process input arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc)
+				usage_error("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		try
+		{
+			if (arg == "--roms")
+				rom_dir = value();
+			else if (arg == "--index")
+				index_path = value();
+			else if (arg == "--frames")
+				limits.max_frames = std::max(1ull, std::stoull(value()));
+			else if (arg == "--ipf")
+				limits.instructions_per_frame = std::max(1ul, std::stoul(value()));
+			else if (arg == "--samples")
+				samples = std::max(1ul, std::stoul(value()));
+			else if (arg == "--sample-time")
+				sample_time = std::stod(value());
+			else if (arg == "--out")
+				out_path = value();
+			else if (arg == "--baseline")
+				baseline_path = value();
+			else if (arg == "--threshold")
+				threshold = std::stod(value());
+			else if (arg == "--jit")
+				jit = true;
+			else
+				usage_error("Invalid CL argument " + arg);
+		}
+		catch (const std::logic_error &)
+		{
+			usage_error("Invalid number for " + arg);
+		}
+	}
+
+	// Every file that is not a text sidecar is a rom, named by its path under the corpus. An index already holds that list, sorted
+	std::vector<std::string> roms;
+	std::unique_ptr<chip8::Catalogue> catalogue;
+	if (!index_path.empty())
+	{
+		catalogue = chip8::Catalogue::open_catalogue(index_path);
+		if (!catalogue)
+			usage_error("File: " + index_path + " is not an index.");
+
+		rom_dir = catalogue->root();
+		for (size_t i = 0; i < catalogue->size(); ++i)
+			roms.emplace_back(catalogue->text((*catalogue)[i].path));
+	}
+	else
+	{
+		std::error_code error;
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(rom_dir, error))
+		{
+			if (entry.is_regular_file() && entry.path().extension() != ".txt")
+				roms.push_back(std::filesystem::relative(entry.path(), rom_dir).generic_string());
+		}
+		std::sort(roms.begin(), roms.end());
+	}
+
+	if (roms.empty())
+		usage_error("No roms found in " + rom_dir);
+
+	// MIPS only compare under the same workload
+	Baseline baseline;
+	if (!baseline_path.empty())
+	{
+		if (!read_baseline(baseline_path, baseline))
+			usage_error("File: " + baseline_path + " failed to open.");
+		if (baseline.frames != limits.max_frames || baseline.instructions_per_frame != limits.instructions_per_frame)
+			usage_error("File: " + baseline_path + " ran " + std::to_string(baseline.frames) + " frames at " +
+						std::to_string(baseline.instructions_per_frame) + " instructions per frame, not " +
+						std::to_string(limits.max_frames) + " at " + std::to_string(limits.instructions_per_frame) + ".");
+	}
+
+	const std::vector<chip8::KeyEvent> script = default_script(limits.max_frames);
+	std::unique_ptr<chip8::FlatMemory> memory = chip8::FlatMemory::makeFlatMemory();
+	chip8::FlatMemory &ram = *memory;
+	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory));
+	interpreter->enable_jit(jit);
+
+	// One run from power on. Every run of a rom is the same, only its time differs
+	auto run_once = [&](const chip8::RomImage &image)
+	{
+		chip8::load_image(ram, image);
+		interpreter->set_quirks(chip8::platform_profile(image.platform).quirks);
+		interpreter->seed(chip8::Interpreter::DEFAULT_SEED);
+		interpreter->reset();
+
+		return chip8::run_headless(*interpreter, limits, script);
+	};
+
+	// A single run takes well under a millisecond, too short to time reliably, so a sample times runs back to back until they took sample_time
+	auto sample = [&](const chip8::RomImage &image)
+	{
+		double total = 0.0;
+		unsigned int runs = 0;
+		for (; runs == 0 || total < sample_time; ++runs)
+			total += run_once(image).seconds;
+		return total / runs;
+	};
+
+	// Samples are taken in rounds over all the roms, so a stretch where the host is slow costs every rom a sample
+	// instead of costing one rom all of them. A busy host only ever makes samples slower, so the lower quartile of
+	// each rom's times counts: robust against up to three quarters of slow samples, unlike the median, and not
+	// decided by a single lucky sample, unlike the fastest
+	auto measure = [&](std::vector<RomResult> &results, const std::vector<std::shared_ptr<const chip8::RomImage>> &images,
+					   const std::vector<size_t> &which, const unsigned int &rounds)
+	{
+		std::vector<std::vector<double>> per_run(which.size());
+		for (unsigned int round = 0; round < rounds; ++round)
+			for (size_t i = 0; i < which.size(); ++i)
+				per_run[i].push_back(sample(*images[which[i]]));
+
+		for (size_t i = 0; i < which.size(); ++i)
+		{
+			std::vector<double> &seconds = per_run[i];
+			std::nth_element(seconds.begin(), seconds.begin() + seconds.size() / 4, seconds.end());
+			results[which[i]].seconds = seconds[seconds.size() / 4];
+		}
+	};
+
+	// One interpreter for every run, so all roms see the same warm allocator and caches
+	std::vector<RomResult> results;
+	std::vector<std::shared_ptr<const chip8::RomImage>> images;
+	chip8::RomCache cache;
+	std::vector<std::shared_ptr<const chip8::RomImage>> group_images(catalogue ? catalogue->groups() : 0);
+	for (size_t i = 0; i < roms.size(); ++i)
+	{
+		const std::string &rom = roms[i];
+
+		// Duplicates the index already grouped are not read again
+		const uint32_t group = catalogue ? (*catalogue)[i].group : 0;
+		const bool grouped = group < group_images.size();
+		std::shared_ptr<const chip8::RomImage> image = grouped ? group_images[group] : nullptr;
+		chip8::RomStatus status = chip8::RomStatus::OK;
+		if (!image)
+			status = cache.load(rom_dir + "/" + rom, image);
+		if (status != chip8::RomStatus::OK)
+		{
+			std::cerr << "skipped: " << rom << ", " << chip8::to_string(status) << "\n";
+			continue;
+		}
+		if (grouped)
+			group_images[group] = image;
+
+		// Warm up, and the cycles and frames every run of the rom repeats
+		const chip8::RunStats stats = run_once(*image);
+		results.push_back({ rom, stats.cycles, stats.frames, 0.0 });
+		images.push_back(std::move(image));
+	}
+
+	std::vector<size_t> all(results.size());
+	for (size_t i = 0; i < all.size(); ++i)
+		all[i] = i;
+	measure(results, images, all, samples);
+
+	// A slow result has to survive a second measurement with three times the samples, so a host hiccup during one rom is not a regression
+	auto regressed = [&](const RomResult &result)
+	{
+		auto found = baseline.roms.find(result.rom);
+		return found != baseline.roms.end() && found->second.mips > 0 && result.mips() < found->second.mips * (1.0 - threshold);
+	};
+
+	std::vector<size_t> slow;
+	for (size_t i = 0; i < results.size(); ++i)
+		if (regressed(results[i]))
+			slow.push_back(i);
+	measure(results, images, slow, 3 * samples);
+
+	if (out_path.empty())
+		write_json(std::cout, results, limits.max_frames, limits.instructions_per_frame);
+	else
+	{
+		std::ofstream f_out(out_path);
+		write_json(f_out, results, limits.max_frames, limits.instructions_per_frame);
+	}
+
+	if (baseline_path.empty())
+		return 0;
+
+	// Roms new to the corpus have nothing to regress from. Every run of a rom executes the same instructions,
+	// so a different cycle count means the emulator behaves differently and the baseline needs regenerating
+	unsigned int regressions = 0, changed = 0;
+	std::cerr << std::fixed << std::setprecision(2);
+	for (const RomResult &result : results)
+	{
+		auto found = baseline.roms.find(result.rom);
+		if (found == baseline.roms.end())
+			continue;
+
+		const Baseline::Rom &before = found->second;
+		if (result.cycles != before.cycles)
+		{
+			std::cerr << "changed: " << result.rom << " ran " << result.cycles << " cycles against " << before.cycles << "\n";
+			++changed;
+		}
+
+		if (!regressed(result))
+			continue;
+
+		std::cerr << "regression: " << result.rom << " " << result.mips() << " MIPS against " << before.mips
+				  << " (" << (result.mips() / before.mips - 1.0) * 100 << "%)\n";
+		++regressions;
+	}
+
+	std::cerr << regressions << " of " << results.size() << " roms slower than the baseline by more than " << threshold * 100 << "%\n";
+	std::cerr << changed << " of " << results.size() << " roms ran a different number of cycles\n";
+	return regressions == 0 && changed == 0 ? 0 : 1;
+}
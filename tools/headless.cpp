@@ -0,0 +1,208 @@
+// Headless runner. Runs a rom at full host speed with no SDL and reports run statistics
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Headless.h"
+#include "../include/Interpreter.h"
+#include "../include/Logger.h"
+#include "../include/Movie.h"
+#include "../include/Rom.h"
+
+namespace
+{
+const char *USAGE =
+	"Usage: headless <rom> [options]\n"
+	"  --cycles N     stop after N instructions\n"
+	"  --frames N     stop after N frames (default 600 when no limit is given)\n"
+	"  --ipf N        instructions per frame (default 10)\n"
+	"  --input FILE   key script, one \"<frame> <key hex> <down|up>\" per line\n"
+	"  --screen FILE  write the final screen as a PBM image\n"
+	"  --stats FILE   write run statistics to FILE instead of stdout\n"
+	"  --movie FILE   replay a movie recorded by main instead, exits with 2 on a desync\n"
+	"  --seed N       seed for Cxnn random numbers (default 0x5EED)\n"
+	"  --quirks SET   none, vip, schip or xochip (default picked from the rom's platform)\n"
+	"  --profile FILE write executions per opcode and the hottest addresses to FILE\n"
+	"  --trace FILE   record executed instructions into a ring mapped to FILE, read it with tracedump\n"
+	"  --trace-size N records the trace ring holds (default 65536)\n"
+	"  --trace-sample N record one instruction in N (default 1)\n"
+	"  --no-loop-stop keep running when the program counter stops moving\n"
+	"  --jit          translate blocks to x86-64 code, interpreting when unsupported\n";
+
+// Print usage and quit
+[[noreturn]] void usage_error(const std::string &msg)
+{
+	util::LOG(LOGTYPE::ERROR, msg);
+	util::Logger::get_instance()->flush();
+	std::cerr << USAGE;
+	std::exit(1);
+}
+} // anonymous namespace
+
+int main(int argc, char **argv){
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+
+	std::string rom_path, input_path, screen_path, stats_path, movie_path, profile_path, trace_path, quirks_name;
+	chip8::RunLimits limits;
+	bool jit = false;
+	uint64_t seed = chip8::Interpreter::DEFAULT_SEED;
+	uint32_t trace_size = 65536, trace_sample = 1;
+
+	// Process input arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc)
+				usage_error("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		try
+		{
+			if (arg == "--cycles")
+				limits.max_cycles = std::stoull(value());
+			else if (arg == "--frames")
+				limits.max_frames = std::stoull(value());
+			else if (arg == "--ipf")
+				limits.instructions_per_frame = std::stoul(value());
+			else if (arg == "--input")
+				input_path = value();
+			else if (arg == "--movie")
+				movie_path = value();
+			else if (arg == "--screen")
+				screen_path = value();
+			else if (arg == "--stats")
+				stats_path = value();
+			else if (arg == "--profile")
+				profile_path = value();
+			else if (arg == "--trace")
+				trace_path = value();
+			else if (arg == "--trace-size")
+				trace_size = std::stoul(value());
+			else if (arg == "--trace-sample")
+				trace_sample = std::stoul(value());
+			else if (arg == "--seed")
+				seed = std::stoull(value(), nullptr, 0);
+			else if (arg == "--quirks")
+				quirks_name = value();
+			else if (arg == "--no-loop-stop")
+				limits.stop_on_loop = false;
+			else if (arg == "--jit")
+				jit = true;
+			else if (arg.rfind("--", 0) == 0 || !rom_path.empty())
+				usage_error("Invalid CL argument " + arg);
+			else
+				rom_path = arg;
+		}
+		catch (const std::logic_error &)
+		{
+			usage_error("Invalid number for " + arg);
+		}
+	}
+
+	if (rom_path.empty())
+		usage_error("No rom supplied. Quitting.");
+
+	// Always have a limit so a busy rom still finishes
+	if (limits.max_cycles == 0 && limits.max_frames == 0)
+		limits.max_frames = 600;
+
+	// Scripted input
+	std::vector<chip8::KeyEvent> script;
+	if (!input_path.empty())
+	{
+		std::ifstream f_input(input_path);
+		std::string error;
+
+		if (!f_input.is_open())
+			usage_error("File: " + input_path + " failed to open.");
+		if (!chip8::parse_input_script(f_input, script, error))
+			usage_error("File: " + input_path + " " + error);
+	}
+
+	std::unique_ptr<chip8::FlatMemory> memory;
+	const chip8::RomStatus rom_status = chip8::load_rom(rom_path, memory);
+	if (rom_status != chip8::RomStatus::OK)
+		usage_error("File: " + rom_path + " " + chip8::to_string(rom_status) + ".");
+
+	// Quirks the rom's platform expects unless named
+	uint8_t quirks = chip8::platform_profile(chip8::detect_platform(memory->data().subspan(chip8::PROG_START))).quirks;
+	if (!quirks_name.empty() && !chip8::parse_quirks(quirks_name, quirks))
+		usage_error("Unknown quirk set " + quirks_name);
+
+	std::unique_ptr<chip8::Interpreter> interpreter = chip8::Interpreter::make_interpreter(std::move(memory));
+	interpreter->seed(seed);
+	interpreter->set_quirks(quirks);
+	if (jit && !interpreter->enable_jit(true))
+		util::LOG(LOGTYPE::ERROR, "Recompiler unsupported, interpreting");
+	interpreter->enable_profiling(!profile_path.empty());
+
+	// Mapped so the records survive the run crashing
+	if (!trace_path.empty())
+	{
+		std::unique_ptr<chip8::TraceRing> ring = chip8::TraceRing::map_trace_file(trace_path, trace_size, trace_sample);
+		if (!ring)
+			usage_error("File: " + trace_path + " can not hold a trace.");
+		interpreter->set_trace(std::move(ring));
+	}
+
+	// A movie brings its own seed, input and length
+	chip8::Movie movie;
+	chip8::ReplayResult replay;
+	chip8::RunStats stats;
+	if (!movie_path.empty())
+	{
+		if (!chip8::read_movie(movie_path, movie))
+			usage_error("File: " + movie_path + " is not a movie.");
+
+		replay = chip8::play_movie(*interpreter, movie);
+		stats.cycles = replay.cycles;
+		stats.frames = replay.frames;
+		stats.seconds = replay.seconds;
+		stats.reason = chip8::StopReason::FRAMES;
+	}
+	else
+		stats = chip8::run_headless(*interpreter, limits, script);
+
+	// Final framebuffer
+	if (!screen_path.empty())
+	{
+		std::ofstream f_screen(screen_path);
+		chip8::write_pbm(f_screen, interpreter->frame());
+	}
+
+	// Hot spots
+	if (!profile_path.empty())
+	{
+		std::ofstream f_profile(profile_path);
+		interpreter->write_profile(f_profile, 40);
+	}
+
+	// Run statistics
+	std::ofstream f_stats;
+	if (!stats_path.empty())
+		f_stats.open(stats_path);
+	std::ostream &out = stats_path.empty() ? std::cout : f_stats;
+
+	out << "rom: " << rom_path << "\n"
+		<< "stop_reason: " << chip8::to_string(stats.reason) << "\n"
+		<< "cycles: " << stats.cycles << "\n"
+		<< "frames: " << stats.frames << "\n"
+		<< "seconds: " << stats.seconds << "\n"
+		<< "instructions_per_second: " << (stats.seconds > 0 ? stats.cycles / stats.seconds : 0.0) << "\n"
+		<< "pc: " << std::hex << "0x" << interpreter->pc() << std::dec << "\n";
+
+	if (!movie_path.empty())
+	{
+		out << "movie_frames: " << movie.keys.size() << "\n"
+			<< "desync: " << (replay.desync ? "frame " + std::to_string(replay.frames) : std::string("none")) << "\n";
+
+		if (replay.desync)
+			return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,206 @@
+// Parallel runner. Runs every rom in a corpus on a work stealing pool and reports scaling from 1 to N threads
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Catalogue.h"
+#include "../include/Logger.h"
+#include "../include/Movie.h"
+#include "../include/ParallelRunner.h"
+
+namespace
+{
+const char *USAGE =
+	"Usage: parallel [options]\n"
+	"  --roms DIR     rom corpus to scan recursively (default roms)\n"
+	"  --index FILE   take the roms from an index written by catalogue instead of scanning\n"
+	"  --cycles N     cycle budget per job (default 200000)\n"
+	"  --repeat N     jobs per rom (default 1)\n"
+	"  --threads N    highest thread count to measure (default every hardware thread)\n"
+	"  --pin          pin worker threads to cpus\n"
+	"  --loop-stop    end a job early once its program counter stops moving\n"
+	"  --movies DIR   replay every <rom file name>.c8m in DIR on its rom instead of cycle budget runs\n"
+	"  --jit          translate blocks to x86-64 code, interpreting when unsupported\n";
+
+// Print usage and quit. Logging is off while the roms run, so the reason goes straight to stderr
+[[noreturn]] void usage_error(const std::string &msg)
+{
+	std::cerr << msg << "\n" << USAGE;
+	std::exit(1);
+}
+} // anonymous namespace
+
+int main(int argc, char **argv){
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::NONE);
+
+	std::string rom_dir = "roms", index_path, movie_dir;
+	uint64_t cycles = 200000;
+	unsigned int repeat = 1;
+	unsigned int max_threads = std::max(1u, std::thread::hardware_concurrency());
+	bool loop_stop = false;
+	chip8::ParallelOptions options;
+
+	// Process input arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= argc)
+				usage_error("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		try
+		{
+			if (arg == "--roms")
+				rom_dir = value();
+			else if (arg == "--index")
+				index_path = value();
+			else if (arg == "--cycles")
+				cycles = std::stoull(value());
+			else if (arg == "--repeat")
+				repeat = std::stoul(value());
+			else if (arg == "--threads")
+				max_threads = std::max(1ul, std::stoul(value()));
+			else if (arg == "--pin")
+				options.pin_threads = true;
+			else if (arg == "--loop-stop")
+				loop_stop = true;
+			else if (arg == "--movies")
+				movie_dir = value();
+			else if (arg == "--jit")
+				options.jit = true;
+			else
+				usage_error("Invalid CL argument " + arg);
+		}
+		catch (const std::logic_error &)
+		{
+			usage_error("Invalid number for " + arg);
+		}
+	}
+
+	// Every file that is not a text sidecar is a rom. An index already holds that list, sorted
+	std::vector<std::string> roms;
+	std::error_code error;
+	if (!index_path.empty())
+	{
+		std::unique_ptr<chip8::Catalogue> catalogue = chip8::Catalogue::open_catalogue(index_path);
+		if (!catalogue)
+			usage_error("File: " + index_path + " is not an index.");
+
+		for (size_t i = 0; i < catalogue->size(); ++i)
+			roms.push_back((std::filesystem::path(std::string(catalogue->root())) / std::string(catalogue->text((*catalogue)[i].path))).string());
+	}
+	else
+	{
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(rom_dir, error))
+		{
+			if (entry.is_regular_file() && entry.path().extension() != ".txt")
+				roms.push_back(entry.path().string());
+		}
+		std::sort(roms.begin(), roms.end());
+	}
+
+	if (roms.empty())
+		usage_error("No roms found in " + rom_dir);
+
+	// Movies are named after the rom file they were recorded on
+	std::vector<chip8::Job> movie_jobs;
+	if (!movie_dir.empty())
+	{
+		for (const auto &entry : std::filesystem::directory_iterator(movie_dir, error))
+		{
+			if (entry.path().extension() != ".c8m")
+				continue;
+
+			auto rom = std::find_if(roms.begin(), roms.end(), [&](const std::string &path) {
+				return std::filesystem::path(path).filename() == entry.path().stem();
+			});
+			auto movie = std::make_shared<chip8::Movie>();
+
+			if (rom == roms.end())
+				std::cerr << "No rom named " << entry.path().stem().string() << " for " << entry.path().string() << "\n";
+			else if (!chip8::read_movie(entry.path().string(), *movie))
+				std::cerr << entry.path().string() << " is not a movie\n";
+			else
+				movie_jobs.push_back({ *rom, {}, {}, movie });
+		}
+
+		if (movie_jobs.empty())
+			usage_error("No movies found in " + movie_dir);
+	}
+
+	std::vector<chip8::Job> jobs;
+	for (unsigned int r = 0; r < repeat; ++r)
+	{
+		if (!movie_jobs.empty())
+		{
+			jobs.insert(jobs.end(), movie_jobs.begin(), movie_jobs.end());
+			continue;
+		}
+
+		for (const auto &rom : roms)
+		{
+			chip8::Job job;
+			job.rom_path = rom;
+			job.limits.max_cycles = cycles;
+			job.limits.stop_on_loop = loop_stop;
+			jobs.push_back(std::move(job));
+		}
+	}
+
+	// Thread counts 1, 2, 4, ... and the maximum
+	std::vector<unsigned int> thread_counts;
+	for (unsigned int t = 1; t < max_threads; t *= 2)
+		thread_counts.push_back(t);
+	thread_counts.push_back(max_threads);
+
+	if (movie_jobs.empty())
+		std::cout << jobs.size() << " jobs over " << roms.size() << " roms, " << cycles << " cycles each\n";
+	else
+		std::cout << jobs.size() << " movie replays over " << movie_jobs.size() << " movies\n";
+	std::cout << std::setw(8) << "threads" << std::setw(12) << "seconds" << std::setw(16) << "instructions"
+			  << std::setw(12) << "MIPS" << std::setw(10) << "speedup" << "\n";
+
+	double base_mips = 0.0;
+	for (unsigned int threads : thread_counts)
+	{
+		options.threads = threads;
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<chip8::JobResult> results = chip8::run_parallel(jobs, options);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		uint64_t instructions = 0, desyncs = 0;
+		for (const auto &result : results)
+		{
+			instructions += result.stats.cycles;
+			desyncs += result.replay.desync;
+		}
+
+		// Replays are deterministic, so one thread count finding a desync means every one does
+		if (desyncs != 0)
+		{
+			for (size_t i = 0; i < movie_jobs.size(); ++i)
+				if (results[i].replay.desync)
+					std::cerr << "desync: " << jobs[i].rom_path << " at frame " << results[i].replay.frames << "\n";
+			return 2;
+		}
+
+		double mips = seconds > 0 ? instructions / seconds / 1e6 : 0.0;
+		if (base_mips == 0.0)
+			base_mips = mips;
+
+		std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+				  << std::setw(16) << instructions << std::setw(12) << std::setprecision(2) << mips
+				  << std::setw(10) << (base_mips > 0 ? mips / base_mips : 0.0) << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,104 @@
+// Trace decoder. Turns a trace file written by --trace into text, readable or made for diffing two runs
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Interpreter.h"
+#include "../include/Logger.h"
+#include "../include/Trace.h"
+
+namespace
+{
+const char *USAGE =
+	"Usage: tracedump <trace> [options]\n"
+	"  --diff   one compact line per record with no header or disassembly, for diffing two traces\n"
+	"  --last N only the newest N records\n";
+
+// Print usage and quit
+[[noreturn]] void usage_error(const std::string &msg)
+{
+	util::LOG(LOGTYPE::ERROR, msg);
+	util::Logger::get_instance()->flush();
+	std::cerr << USAGE;
+	std::exit(1);
+}
+} // anonymous namespace
+
+int main(int argc, char **argv){
+	util::Logger::get_instance()->set_max_log_level(LOGTYPE::ERROR);
+
+	std::string trace_path;
+	bool diff = false;
+	size_t last = 0;
+
+	// Process input arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		try
+		{
+			if (arg == "--diff")
+				diff = true;
+			else if (arg == "--last" && i + 1 < argc)
+				last = std::stoull(argv[++i]);
+			else if (arg.rfind("--", 0) == 0 || !trace_path.empty())
+				usage_error("Invalid CL argument " + arg);
+			else
+				trace_path = arg;
+		}
+		catch (const std::logic_error &)
+		{
+			usage_error("Invalid number for " + arg);
+		}
+	}
+
+	if (trace_path.empty())
+		usage_error("No trace supplied. Quitting.");
+
+	chip8::TraceHeader header;
+	std::vector<chip8::TraceRecord> records;
+	if (!chip8::read_trace(trace_path, header, records))
+		return 1;
+
+	const size_t first = last > 0 && last < records.size() ? records.size() - last : 0;
+
+	if (!diff)
+	{
+		std::cout << "capacity: " << header.capacity << ", sample: 1 in " << header.sample << ", written: " << header.written
+				  << ", held: " << records.size() << "\n\n"
+				  << "           cycle  pc     opcode  I      Vx       disassembly\n";
+	}
+
+	char line[128];
+	for (size_t i = first; i < records.size(); ++i)
+	{
+		const chip8::TraceRecord &record = records[i];
+		const bool changed = chip8::writes_vx(record.opcode);
+
+		if (diff)
+		{
+			std::snprintf(line, sizeof(line), "%llu %03X %04X %03X", (unsigned long long)record.cycle, record.pc, record.opcode, record.index);
+			std::cout << line;
+			if (changed)
+			{
+				std::snprintf(line, sizeof(line), " V%X=%02X", record.x, record.vx);
+				std::cout << line;
+			}
+			std::cout << "\n";
+			continue;
+		}
+
+		char reg[16] = "";
+		if (changed)
+			std::snprintf(reg, sizeof(reg), "V%X=0x%02X", record.x, record.vx);
+
+		std::snprintf(line, sizeof(line), "%16llu  0x%03X  %04X    0x%03X  %-7s  ", (unsigned long long)record.cycle, record.pc,
+					  record.opcode, record.index, reg);
+		std::cout << line << chip8::Interpreter::disassemble(record.opcode) << "\n";
+	}
+
+	return 0;
+}